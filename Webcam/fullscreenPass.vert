@@ -0,0 +1,12 @@
+#version 330 core
+out vec2 UV;
+
+// Vertex shader for the intermediate passes of a PassChain. One triangle
+// covers the whole render target; no vertex buffer is needed. UV is not
+// flipped, so the target keeps the source texture's top-down row order
+// and later passes sample it exactly like the video texture.
+void main() {
+    vec2 p = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);
+    UV = p;
+    gl_Position = vec4(p * 2.0 - 1.0, 0.0, 1.0);
+}
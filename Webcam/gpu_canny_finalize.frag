@@ -0,0 +1,11 @@
+#version 330 core
+// Last pass of the GPU Canny: strong pixels are edges (255), weak ones that
+// hysteresis never reached are dropped, as in Filters::applyCannyCPU.
+out vec4 FragColor;
+
+uniform sampler2D texture1;  // class map: 0 none, 0.5 weak, 1 strong
+
+void main() {
+    float c = texelFetch(texture1, ivec2(gl_FragCoord.xy), 0).r;
+    FragColor = vec4(c > 0.75 ? 1.0 : 0.0);
+}
@@ -0,0 +1,37 @@
+#version 330 core
+// First pass of the GPU Canny (see Filters::GPUCanny): integer luma, 3x3
+// Sobel and L1 magnitude, computed exactly like Filters::CannyEngine so
+// the result can be compared with the CPU filter pixel for pixel. Writes
+// (magnitude, dx, dy) into a GL_RGBA16F target; every value is an integer
+// below 2048, which half floats hold exactly.
+out vec4 FragColor;
+
+uniform sampler2D texture1;
+
+// Luma as in Filters::applyGrayscaleCPU (8-bit BT.601 weights, rounded).
+// Borders replicate, like the CPU Sobel. Gray frames are swizzled to
+// (r, r, r, 1) and come out unchanged.
+int luma(ivec2 p, ivec2 size) {
+    p = clamp(p, ivec2(0), size - 1);
+    ivec3 c = ivec3(texelFetch(texture1, p, 0).rgb * 255.0 + 0.5);
+    return (29 * c.b + 150 * c.g + 77 * c.r + 128) >> 8;
+}
+
+void main() {
+    ivec2 size = textureSize(texture1, 0);
+    // Render targets keep the source's top-down rows: y - 1 is the row
+    // above.
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    int tl = luma(p + ivec2(-1, -1), size);
+    int tc = luma(p + ivec2(0, -1), size);
+    int tr = luma(p + ivec2(1, -1), size);
+    int ml = luma(p + ivec2(-1, 0), size);
+    int mr = luma(p + ivec2(1, 0), size);
+    int bl = luma(p + ivec2(-1, 1), size);
+    int bc = luma(p + ivec2(0, 1), size);
+    int br = luma(p + ivec2(1, 1), size);
+
+    int dx = (tr + 2 * mr + br) - (tl + 2 * ml + bl);
+    int dy = (bl + 2 * bc + br) - (tl + 2 * tc + tr);
+    FragColor = vec4(float(abs(dx) + abs(dy)), float(dx), float(dy), 1.0);
+}
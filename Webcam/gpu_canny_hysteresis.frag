@@ -0,0 +1,70 @@
+#version 330 core
+// One hysteresis step of the GPU Canny: a weak pixel (0.5) becomes strong
+// (1.0) when a strong pixel reaches it through weak ones inside its 7x7
+// neighbourhood, so each pass grows edges by at least three pixels along
+// any chain instead of one. The passes repeat until nothing changes or the
+// pass cap is reached; the result is the same as growing one pixel at a
+// time, only in fewer passes.
+//
+// With PROBE defined nothing is written: pixels that would still change
+// (weak ones next to a strong one) pass, all others are discarded, so an
+// occlusion query around the draw tells whether another pass is needed.
+out vec4 FragColor;
+
+uniform sampler2D texture1;  // class map: 0 none, 0.5 weak, 1 strong
+
+const int kRadius = 3;
+const int kSide = 2 * kRadius + 1;
+// Raster sweeps over the neighbourhood, alternating direction; each
+// carries the strong class along any chain running with the sweep.
+const int kSweeps = 4;
+
+// 0 none, 1 weak, 2 strong; zero outside the image.
+int classAt(ivec2 q, ivec2 size) {
+    if (any(lessThan(q, ivec2(0))) || any(greaterThanEqual(q, size)))
+        return 0;
+    float c = texelFetch(texture1, q, 0).r;
+    return c > 0.75 ? 2 : (c > 0.25 ? 1 : 0);
+}
+
+void main() {
+    ivec2 size = textureSize(texture1, 0);
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    float c = texelFetch(texture1, p, 0).r;
+    bool grow = false;
+#ifdef PROBE
+    if (c > 0.25 && c < 0.75) {
+        for (int y = -1; y <= 1; ++y)
+            for (int x = -1; x <= 1; ++x)
+                grow = grow || classAt(p + ivec2(x, y), size) == 2;
+    }
+    if (!grow) discard;
+    FragColor = vec4(1.0);
+#else
+    if (c > 0.25 && c < 0.75) {
+        int cells[kSide * kSide];
+        bool anyStrong = false;
+        for (int y = 0; y < kSide; ++y)
+            for (int x = 0; x < kSide; ++x) {
+                int v = classAt(p + ivec2(x - kRadius, y - kRadius), size);
+                cells[y * kSide + x] = v;
+                anyStrong = anyStrong || v == 2;
+            }
+        for (int sweep = 0; anyStrong && !grow && sweep < kSweeps; ++sweep) {
+            for (int k = 0; k < kSide * kSide; ++k) {
+                int i = (sweep % 2 == 0) ? k : kSide * kSide - 1 - k;
+                if (cells[i] != 1) continue;
+                int y = i / kSide, x = i - y * kSide;
+                bool reached = false;
+                for (int ny = max(y - 1, 0); ny <= min(y + 1, kSide - 1); ++ny)
+                    for (int nx = max(x - 1, 0); nx <= min(x + 1, kSide - 1);
+                         ++nx)
+                        reached = reached || cells[ny * kSide + nx] == 2;
+                if (reached) cells[i] = 2;
+            }
+            grow = cells[kRadius * kSide + kRadius] == 2;
+        }
+    }
+    FragColor = vec4(grow ? 1.0 : c);
+#endif
+}
@@ -0,0 +1,49 @@
+#version 330 core
+// Second pass of the GPU Canny: non-maximum suppression along the gradient
+// direction and the double threshold, with the same integer direction test
+// (tan 22.5 degrees in Q15) and tie-breaking as Filters::CannyEngine.
+// Writes the pixel class into a GL_R8 target: 0 none, 0.5 weak, 1 strong.
+out vec4 FragColor;
+
+uniform sampler2D texture1;  // (magnitude, dx, dy) from gpu_canny_gradient
+uniform ivec2 thresholds;    // (low, high), already floored
+
+const int kCannyShift = 15;
+const int kTan22 = 13573;  // round(tan(22.5 deg) * 2^15)
+
+// Magnitude of a neighbour; zero outside the image, as in cv::Canny.
+int magnitude(ivec2 p, ivec2 size) {
+    if (any(lessThan(p, ivec2(0))) || any(greaterThanEqual(p, size)))
+        return 0;
+    return int(texelFetch(texture1, p, 0).r);
+}
+
+void main() {
+    ivec2 size = textureSize(texture1, 0);
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec4 g = texelFetch(texture1, p, 0);
+    int m = int(g.r);
+    FragColor = vec4(0.0);
+    if (m <= thresholds.x) return;
+
+    int xs = int(g.g), ys = int(g.b);
+    int ax = abs(xs);
+    int ay = abs(ys) << kCannyShift;
+    int tg22x = ax * kTan22;
+    bool peak;
+    if (ay < tg22x) {
+        peak = m > magnitude(p + ivec2(-1, 0), size) &&
+               m >= magnitude(p + ivec2(1, 0), size);
+    } else {
+        int tg67x = tg22x + (ax << (kCannyShift + 1));
+        if (ay > tg67x) {
+            peak = m > magnitude(p + ivec2(0, -1), size) &&
+                   m >= magnitude(p + ivec2(0, 1), size);
+        } else {
+            int s = ((xs < 0) != (ys < 0)) ? -1 : 1;
+            peak = m > magnitude(p + ivec2(-s, -1), size) &&
+                   m > magnitude(p + ivec2(s, 1), size);
+        }
+    }
+    if (peak) FragColor = vec4(m > thresholds.y ? 1.0 : 0.5);
+}
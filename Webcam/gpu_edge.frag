@@ -4,12 +4,17 @@ out vec4 FragColor;
 
 uniform sampler2D texture1;
 
-// texelOffset can be set from the program if desired. If not provided,
-// the shader uses a reasonable default.
-uniform vec2 texelOffset; // expected to be (1.0/width, 1.0/height)
-// Optional threshold to suppress weak edges on the GPU.
-// If <= 0.0 the shader preserves the original behavior (no threshold).
-uniform float edgeThreshold;
+// Per-frame parameters, shared by all programs (see FrameUniforms).
+layout(std140) uniform FrameParams {
+    mat3 uTransform;
+    // (1.0/width, 1.0/height). If not provided, the shader uses a
+    // reasonable default.
+    vec2 texelOffset;
+    // Optional threshold to suppress weak edges on the GPU.
+    // If <= 0.0 the shader preserves the original behavior (no threshold).
+    float edgeThreshold;
+    int pixelSize;
+};
 
 void main() {
     vec2 off = texelOffset;
@@ -1,23 +1,23 @@
-// language: glsl
 #version 330 core
+// Second half of the GPU pixelate: nearest-neighbour expansion of the
+// block means written by gpu_pixelate_reduce.frag back to full resolution.
 in vec2 UV;
 out vec4 FragColor;
 
-uniform sampler2D texture1; // your video texture
+uniform sampler2D texture1; // block means, one texel per block
 
-void main() {
-    // size of one block in UV space
-    ivec2 sz = textureSize(texture1, 0);
-    vec2 texSize = vec2(sz);
-    vec2 blockUV = 10 / texSize;
-
-    vec2 blockOrigin = floor(UV / blockUV) * blockUV;
-    vec2 center = blockOrigin + 0.5 * blockUV;
+// Per-frame parameters, shared by all programs (see FrameUniforms).
+layout(std140) uniform FrameParams {
+    mat3 uTransform;
+    vec2 texelOffset;
+    float edgeThreshold;
+    int pixelSize;
+};
 
-    vec2 q = blockUV * 0.25; // quarter-block offsets
-    vec4 c1 = texture(texture1, center + vec2(-q.x, -q.y));
-    vec4 c2 = texture(texture1, center + vec2( q.x, -q.y));
-    vec4 c3 = texture(texture1, center + vec2(-q.x,  q.y));
-    vec4 c4 = texture(texture1, center + vec2( q.x,  q.y));
-    FragColor = (c1 + c2 + c3 + c4) * 0.25;
-}
\ No newline at end of file
+void main() {
+    // texelOffset is one full-resolution pixel, so this is the source
+    // pixel under the fragment.
+    vec2 size = floor(1.0 / texelOffset + 0.5);
+    ivec2 pixel = ivec2(clamp(floor(UV * size), vec2(0.0), size - 1.0));
+    FragColor = texelFetch(texture1, pixel / max(pixelSize, 1), 0);
+}
@@ -0,0 +1,36 @@
+#version 330 core
+// First half of the GPU pixelate: renders into a target with one texel per
+// block (ceil(width / pixelSize) x ceil(height / pixelSize)) and writes the
+// exact mean of the block, like Filters::applyPixelateCPU. Blocks on the
+// right and bottom edge average only the pixels they cover. Every source
+// pixel is read once in total. gpu_pixelate.frag expands the result.
+out vec4 FragColor;
+
+uniform sampler2D texture1;
+
+// Per-frame parameters, shared by all programs (see FrameUniforms).
+layout(std140) uniform FrameParams {
+    mat3 uTransform;
+    vec2 texelOffset;
+    float edgeThreshold;
+    int pixelSize;
+};
+
+void main() {
+    ivec2 size = textureSize(texture1, 0);
+    int block = max(pixelSize, 1);
+    // Target rows keep the source's top-down order, so block (0, 0) is the
+    // top-left one, as on the CPU.
+    ivec2 first = ivec2(gl_FragCoord.xy) * block;
+    ivec2 last = min(first + block, size);
+    vec4 sum = vec4(0.0);
+    for (int y = first.y; y < last.y; ++y) {
+        for (int x = first.x; x < last.x; ++x) {
+            sum += texelFetch(texture1, ivec2(x, y), 0);
+        }
+    }
+    ivec2 n = max(last - first, ivec2(1));
+    // Stored as 8-bit unorm, i.e. rounded to nearest like the CPU's
+    // (sum + n / 2) / n.
+    FragColor = sum / float(n.x * n.y);
+}
@@ -3,12 +3,20 @@ in vec2 UV;
 out vec4 FragColor;
 
 uniform sampler2D texture1;
-// 3x3 affine transform applied to UV (vec3(UV,1.0))
-uniform mat3 uTransform;
+// Per-frame parameters, shared by all programs (see FrameUniforms).
+layout(std140) uniform FrameParams {
+    // 3x3 affine transform applied to UV (vec3(UV,1.0))
+    mat3 uTransform;
+    vec2 texelOffset;
+    float edgeThreshold;
+    int pixelSize;
+};
 
 void main() {
-    vec3 t = uTransform * vec3(UV, 1.0);
-    vec2 uv = t.xy;
+    // uTransform works in image UV with V up (shared with the CPU path);
+    // the texture is stored top-down, so flip V on the way in and out.
+    vec3 t = uTransform * vec3(UV.x, 1.0 - UV.y, 1.0);
+    vec2 uv = vec2(t.x, 1.0 - t.y);
     // If the transformed UV lies outside the texture, discard the
     // fragment so the background shows through instead of clamping to
     // the edge texel (which produces the 'smeared' artifact when zooming).
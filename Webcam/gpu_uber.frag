@@ -0,0 +1,74 @@
+#version 330 core
+// Uber-shader: the GPU filters and the UV transform fused into one pass.
+// ShaderCache injects the permutation's #defines after the #version line:
+// at most one of FILTER_GRAY, FILTER_EDGE and FILTER_PIXELATE, plus
+// TRANSFORM (see Filters::gpuUberPermutations()). Gray and edge match the
+// standalone gpu_*.frag shaders. Pixelate fuses the expansion of
+// gpu_pixelate.frag: texture1 then holds the exact block means written by
+// gpu_pixelate_reduce.frag, which runs as a pass of its own before this.
+in vec2 UV;
+out vec4 FragColor;
+
+uniform sampler2D texture1;  // the frame, or block means for pixelate
+
+// Per-frame parameters, shared by all programs (see FrameUniforms).
+layout(std140) uniform FrameParams {
+    mat3 uTransform;
+    vec2 texelOffset;
+    float edgeThreshold;
+    int pixelSize;
+};
+
+const vec3 kLuma = vec3(0.299, 0.587, 0.114);
+
+float luma(vec2 uv) {
+    return dot(texture(texture1, uv).rgb, kLuma);
+}
+
+void main() {
+    vec2 uv = UV;
+#ifdef TRANSFORM
+    // uTransform works in image UV with V up (shared with the CPU path);
+    // the texture is stored top-down, so flip V on the way in and out.
+    vec3 t = uTransform * vec3(uv.x, 1.0 - uv.y, 1.0);
+    uv = vec2(t.x, 1.0 - t.y);
+    if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) {
+        discard;
+    }
+#endif
+
+#if defined(FILTER_GRAY)
+    FragColor = vec4(vec3(luma(uv)), 1.0);
+#elif defined(FILTER_EDGE)
+    vec2 off = texelOffset;
+    if (off.x == 0.0 && off.y == 0.0) {
+        off = vec2(1.0/512.0, 1.0/512.0);
+    }
+    float tl = luma(uv + vec2(-off.x, -off.y));
+    float tc = luma(uv + vec2(0.0, -off.y));
+    float tr = luma(uv + vec2(off.x, -off.y));
+    float ml = luma(uv + vec2(-off.x, 0.0));
+    float mr = luma(uv + vec2(off.x, 0.0));
+    float bl = luma(uv + vec2(-off.x, off.y));
+    float bc = luma(uv + vec2(0.0, off.y));
+    float br = luma(uv + vec2(off.x, off.y));
+
+    float gx = (tr + 2.0*mr + br) - (tl + 2.0*ml + bl);
+    float gy = (bl + 2.0*bc + br) - (tl + 2.0*tc + tr);
+    float g = length(vec2(gx, gy));
+    if (edgeThreshold <= 0.0) {
+        FragColor = vec4(vec3(g), 1.0);
+    } else {
+        float edge = smoothstep(edgeThreshold, edgeThreshold + 0.05, g);
+        FragColor = vec4(vec3(edge), 1.0);
+    }
+#elif defined(FILTER_PIXELATE)
+    // texelOffset is one full-resolution pixel, so this is the source
+    // pixel under the (transformed) fragment.
+    vec2 size = floor(1.0 / texelOffset + 0.5);
+    ivec2 pixel = ivec2(clamp(floor(uv * size), vec2(0.0), size - 1.0));
+    FragColor = texelFetch(texture1, pixel / max(pixelSize, 1), 0);
+#else
+    FragColor = texture(texture1, uv);
+#endif
+}
@@ -1,797 +1,1577 @@
-/*
- * OpenCV to OpenGL Exercise
- *
- * GOAL: Render a live video feed from a camera onto a 3D object using OpenGL.
- *
- * INSTRUCTIONS:
- * This file is partially complete. Your main task is to complete the section
- * marked "TODO" to create the initial OpenGL texture from a camera frame.
- *
- * The rendering loop has been completed for you as an example.
- *
- */
-
-#include <glad/gl.h>
-#include <stdio.h>
-#include <stdlib.h>
-
-#include <chrono>
-#include <cmath>
-#include <fstream>
-#include <iostream>
-#include <sstream>
-#include <string>
-#include <vector>
-#define GLAD_GL_IMPLEMENTATION
-
-#include <GLFW/glfw3.h>
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-using namespace glm;
-
-#include <common/Camera.hpp>
-#include <common/ColorShader.hpp>
-#include <common/Object.hpp>
-#include <common/Quad.hpp>
-#include <common/Scene.hpp>
-#include <common/Shader.hpp>
-#include <common/Texture.hpp>
-#include <common/TextureShader.hpp>
-#include <opencv2/opencv.hpp>
-
-#include "filters/Filters.hpp"
-#include "transforms/Transforms.hpp"
-
-using namespace std;
-
-GLFWwindow* window;
-
-// Helper function to initialize the window
-bool initWindow(std::string windowName);
-
-// --- Simple global transform state for mouse interaction (UV space) -----
-static bool g_isDragging = false;
-static double g_lastX = 0.0, g_lastY = 0.0;
-static float g_translateU = 0.0f, g_translateV = 0.0f;
-static float g_scale = 1.0f;
-static float g_rotation = 0.0f;  // degrees, positive = CCW
-// Last zoom cursor position in UV (0..1). Used so CPU scaling can pivot
-// about the cursor point.
-static float g_zoomPivotU = 0.5f, g_zoomPivotV = 0.5f;
-// Transform toggles accessible from callbacks
-static bool g_transformsEnabled = false;
-static bool g_transformsUseCPU =
-    false;  // when true, apply transforms on CPU (cv::Mat)
-static bool g_gpuTransformActive =
-    false;  // whether we have set the GPU transform shader
-
-// GLFW callbacks (defined here so they can access the static globals)
-static void scroll_callback(GLFWwindow* win, double xoffset, double yoffset) {
-    // Zoom around current cursor position
-    double mx, my;
-    int w, h;
-    glfwGetCursorPos(win, &mx, &my);
-    glfwGetWindowSize(win, &w, &h);
-    if (w <= 0 || h <= 0) return;
-    // If GPU, invert mx and my
-    if (g_gpuTransformActive) {
-        mx = w - mx;
-        my = h - my;
-    }
-    // Convert to UV (0..1). Note: window y is top-down so invert Y to get
-    // UV-space where V increases upwards.
-    float px = (float)(mx / (double)w);
-    float py = (float)(my / (double)h);
-
-    // Record pivot for CPU scaling (in UV coordinates). For CPU path we
-    // will map these to pixel coordinates before calling applyScaleCPU.
-    g_zoomPivotU = px;
-    g_zoomPivotV = py;
-
-    float oldScale = g_scale;
-    // scale exponentially for smooth zooming
-    // if GPU, invert zoom direction
-    float dir = g_gpuTransformActive ? -1.0f : 1.0f;
-    float factor = powf(1.1f, (float)yoffset * dir);
-    float newScale = oldScale * factor;
-
-    // Keep the point under cursor fixed. The shader composes scale around
-    // the image center, so we must account for the center (cx,cy).
-    // Derived: t_new = t_old + (s_old - s_new) * (p - c)
-    float s_old = oldScale;
-    float s_new = newScale;
-    float cx = 0.5f, cy = 0.5f;
-    g_translateU = g_translateU + (s_old - s_new) * (px - cx);
-    g_translateV = g_translateV + (s_old - s_new) * (py - cy);
-    g_scale = s_new;
-}
-
-static void mouse_button_callback(GLFWwindow* win, int button, int action,
-                                  int mods) {
-    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
-    if (action == GLFW_PRESS) {
-        g_isDragging = true;
-        glfwGetCursorPos(win, &g_lastX, &g_lastY);
-    } else if (action == GLFW_RELEASE) {
-        g_isDragging = false;
-    }
-}
-
-static void cursor_pos_callback(GLFWwindow* win, double xpos, double ypos) {
-    if (!g_isDragging) return;
-    int w, h;
-    glfwGetWindowSize(win, &w, &h);
-    if (w <= 0 || h <= 0) return;
-    double dx = xpos - g_lastX;
-    double dy = ypos - g_lastY;
-    // Convert pixel delta to UV delta. GLFW Y is top-down, so invert the
-    // vertical delta: moving the mouse up should increase V.
-    // If shift is held, interpret horizontal drag as rotation.
-    int shiftLeft = glfwGetKey(win, GLFW_KEY_LEFT_SHIFT);
-    int shiftRight = glfwGetKey(win, GLFW_KEY_RIGHT_SHIFT);
-    if (shiftLeft == GLFW_PRESS || shiftRight == GLFW_PRESS) {
-        // rotation sensitivity: degrees per pixel (tweakable)
-        const float rotSens = 0.35f;
-        g_rotation += (float)dx * rotSens;
-    } else {
-        float du = (float)(dx / (double)w);
-        float dv = (float)(dy / (double)h);
-        g_translateU += du;
-        g_translateV += dv;
-    }
-    g_lastX = xpos;
-    g_lastY = ypos;
-}
-
-/* ------------------------------------------------------------------------- */
-/* main                                                                      */
-/* ------------------------------------------------------------------------- */
-int main(int argc, char** argv) {
-    // --- Simple CLI parsing for benchmarking -------------------------
-    bool doBenchmark = false;
-    std::string benchmarkOut = "benchmark.csv";
-    std::string filterArg = "none";     // none, gray, edge, pixelate
-    std::string backendArg = "gpu";     // cpu or gpu (filter backend)
-    std::string transformsArg = "off";  // off, cpu, gpu
-    // optional initial transform values (for benchmark runs)
-    float presetTranslateU = 0.0f;
-    float presetTranslateV = 0.0f;
-    float presetScale = 1.0f;
-    float presetRotation = 0.0f;            // degrees
-    int targetWidth = 0, targetHeight = 0;  // 0 = native
-    int benchFrames = 300;
-    bool detailedBenchmark = false;
-
-    for (int i = 1; i < argc; ++i) {
-        std::string a = argv[i];
-        if (a == "--benchmark")
-            doBenchmark = true;
-        else if (a == "--out" && i + 1 < argc)
-            benchmarkOut = argv[++i];
-        else if (a == "--filter" && i + 1 < argc)
-            filterArg = argv[++i];
-        else if (a == "--backend" && i + 1 < argc)
-            backendArg = argv[++i];
-        else if (a == "--transforms" && i + 1 < argc)
-            transformsArg = argv[++i];
-        else if (a == "--translateU" && i + 1 < argc)
-            presetTranslateU = std::stof(argv[++i]);
-        else if (a == "--translateV" && i + 1 < argc)
-            presetTranslateV = std::stof(argv[++i]);
-        else if (a == "--scale" && i + 1 < argc)
-            presetScale = std::stof(argv[++i]);
-        else if (a == "--rotation" && i + 1 < argc)
-            presetRotation = std::stof(argv[++i]);
-        else if (a == "--resolution" && i + 1 < argc) {
-            std::string res = argv[++i];
-            size_t x = res.find('x');
-            if (x != std::string::npos) {
-                targetWidth = std::stoi(res.substr(0, x));
-                targetHeight = std::stoi(res.substr(x + 1));
-            }
-        } else if (a == "--frames" && i + 1 < argc) {
-            benchFrames = std::stoi(argv[++i]);
-        } else if (a == "--detailed") {
-            detailedBenchmark = true;
-        }
-    }
-    // Open camera
-    cv::VideoCapture cap(1);
-    if (!cap.isOpened()) {
-        cerr << "Error: Could not open camera. Exiting." << endl;
-        return -1;
-    }
-    cout << "Camera opened successfully." << endl;
-
-    // Initialize OpenGL context
-    if (!initWindow("Webcam")) return -1;
-
-    int version = gladLoadGL(glfwGetProcAddress);
-    if (version == 0) {
-        fprintf(stderr, "Failed to initialize OpenGL context (GLAD)\n");
-        cap.release();
-        return -1;
-    }
-    cout << "Loaded OpenGL " << GLAD_VERSION_MAJOR(version) << "."
-         << GLAD_VERSION_MINOR(version) << "\n";
-
-    // Basic OpenGL setup
-    glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
-    // Install mouse/scroll callbacks for interactive transforms
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetMouseButtonCallback(window, mouse_button_callback);
-    glfwSetCursorPosCallback(window, cursor_pos_callback);
-    glClearColor(0.1f, 0.1f, 0.2f, 0.0f);  // A dark blue background
-    glEnable(GL_DEPTH_TEST);
-
-    GLuint VertexArrayID;
-    glGenVertexArrays(1, &VertexArrayID);
-    glBindVertexArray(VertexArrayID);
-
-    // Prepare Scene, Shaders, and Objects
-
-    // We get one frame from the camera to determine its size.
-    cv::Mat frame;
-    cap >> frame;
-    if (frame.empty()) {
-        cerr << "Error: couldn't capture an initial frame from camera. "
-                "Exiting.\n";
-        cap.release();
-        glfwTerminate();
-        return -1;
-    }
-
-    // Create objects needed for rendering.
-    TextureShader* textureShader =
-        new TextureShader("videoTextureShader.vert", "videoTextureShader.frag");
-    Scene* myScene = new Scene();
-    Camera* renderingCamera = new Camera();
-    renderingCamera->setPosition(glm::vec3(0, 0, -2.5));
-
-    // Calculate aspect ratio and create a quad with the correct dimensions.
-    float videoAspectRatio = (float)frame.cols / (float)frame.rows;
-    Quad* myQuad = new Quad(videoAspectRatio);
-    myQuad->setShader(textureShader);
-    myScene->addObject(myQuad);
-
-    // This variable will hold our OpenGL texture.
-    Texture* videoTexture = nullptr;
-
-    // Flip image on the x-axis
-    cv::flip(frame, frame, 0);
-    videoTexture = new Texture(frame.data, frame.cols, frame.rows, true);
-
-    // We must tell the shader which texture to use.
-    textureShader->setTexture(videoTexture);
-
-    // If user requested a target resolution, set capture properties now.
-    if (targetWidth > 0 && targetHeight > 0) {
-        cap.set(cv::CAP_PROP_FRAME_WIDTH, targetWidth);
-        cap.set(cv::CAP_PROP_FRAME_HEIGHT, targetHeight);
-        cout << "Requested camera resolution: " << targetWidth << "x"
-             << targetHeight << endl;
-        // Re-query an initial frame at new resolution
-        cap >> frame;
-        if (!frame.empty()) {
-            cv::flip(frame, frame, 0);
-            videoTexture->update(frame.data, frame.cols, frame.rows, true);
-        }
-    }
-
-    // If benchmarking was requested, configure filters/transforms accordingly
-    std::ofstream csvOut;
-    std::ofstream csvDetailedOut;
-    std::vector<double> frameTimesMs;
-    std::string buildType =
-#ifdef NDEBUG
-        "Release";
-#else
-        "Debug";
-#endif
-
-    // (Benchmark configuration that needs runtime symbols is done later
-    // after shader helper lambdas and FilterMode are declared.)
-
-    // Keys we watch for toggles (kept for backwards compatibility)
-    // Add T = toggle transforms on/off, C = toggle CPU/GPU transform mode
-    const int keysToWatch[] = {GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_4,
-                               GLFW_KEY_G, GLFW_KEY_E, GLFW_KEY_P, GLFW_KEY_T,
-                               GLFW_KEY_C, GLFW_KEY_R};
-    bool prevKeyState[sizeof(keysToWatch) / sizeof(keysToWatch[0])] = {false};
-
-    // Transform toggles
-    // (moved to file-level globals so callbacks can see them)
-
-    auto setDefaultShaderOnQuad = [&](void) {
-        TextureShader* sh = new TextureShader("videoTextureShader.vert",
-                                              "videoTextureShader.frag");
-        sh->setTexture(videoTexture);
-        myQuad->setShader(
-            sh);  // Object takes ownership and will delete previous shader
-    };
-
-    auto setGPUShaderOnQuad = [&](const std::string& fragPath) {
-        TextureShader* sh =
-            new TextureShader("videoTextureShader.vert", fragPath);
-        sh->setTexture(videoTexture);
-        myQuad->setShader(sh);
-    };
-
-    cout << "Filter keys: 1=None, 2=CPU Gray, 3=CPU Edge, 4=CPU Pixelate, "
-            "G=GPU Gray, E=GPU Edge, P=GPU Pixelate"
-         << endl;
-
-    // Make variables to track current filter
-    enum class FilterMode {
-        NONE,
-        CPU_GRAY,
-        CPU_EDGE,
-        CPU_PIXELATE,
-        GPU_GRAY,
-        GPU_EDGE,
-        GPU_PIXELATE
-    };
-    FilterMode currentMode = FilterMode::NONE;
-
-    // If benchmarking was requested, configure filters/transforms accordingly
-    if (doBenchmark) {
-        cout << "Running in BENCHMARK mode -> " << benchmarkOut << "\n";
-        std::string fa = filterArg;
-        for (auto& c : fa) c = (char)tolower(c);
-        std::string be = backendArg;
-        for (auto& c : be) c = (char)tolower(c);
-
-        if (fa == "none") {
-            setDefaultShaderOnQuad();
-            currentMode = FilterMode::NONE;
-        } else if (fa == "gray") {
-            if (be == "cpu") {
-                currentMode = FilterMode::CPU_GRAY;
-                setDefaultShaderOnQuad();
-            } else {
-                currentMode = FilterMode::GPU_GRAY;
-                setGPUShaderOnQuad(Filters::gpuFragmentPathGrayscale());
-            }
-        } else if (fa == "edge") {
-            if (be == "cpu") {
-                currentMode = FilterMode::CPU_EDGE;
-                setDefaultShaderOnQuad();
-            } else {
-                currentMode = FilterMode::GPU_EDGE;
-                setGPUShaderOnQuad(Filters::gpuFragmentPathEdge());
-            }
-        } else if (fa == "pixelate") {
-            if (be == "cpu") {
-                currentMode = FilterMode::CPU_PIXELATE;
-                setDefaultShaderOnQuad();
-            } else {
-                currentMode = FilterMode::GPU_PIXELATE;
-                setGPUShaderOnQuad(Filters::gpuFragmentPathPixelate());
-            }
-        } else {
-            cout << "Unknown filter name '" << filterArg
-                 << "', defaulting to none\n";
-            setDefaultShaderOnQuad();
-            currentMode = FilterMode::NONE;
-        }
-
-        // Transforms argument: off, cpu, gpu
-        if (transformsArg == "cpu") {
-            g_transformsEnabled = true;
-            g_transformsUseCPU = true;
-            g_gpuTransformActive = false;
-        } else if (transformsArg == "gpu") {
-            g_transformsEnabled = true;
-            g_transformsUseCPU = false;
-            setGPUShaderOnQuad(Transforms::gpuFragmentPathTransform());
-            g_gpuTransformActive = true;
-        } else {
-            g_transformsEnabled = false;
-            g_transformsUseCPU = false;
-            g_gpuTransformActive = false;
-        }
-
-        // If transforms are enabled for the benchmark, apply any preset
-        // transform values provided on the CLI so the run exercises
-        // non-identity transforms.
-        if (g_transformsEnabled) {
-            g_translateU = presetTranslateU;
-            g_translateV = presetTranslateV;
-            g_scale = presetScale;
-            g_rotation = presetRotation;
-            // keep current pivot at center unless user adjusted g_zoomPivot
-        }
-
-        // Open CSV for writing
-        csvOut.open(benchmarkOut);
-        if (!csvOut.is_open()) {
-            cerr << "Could not open output CSV '" << benchmarkOut
-                 << "' for writing. Will print to stdout instead.\n";
-        } else {
-            csvOut << "frame_ms,frame_index,filter,backend,resolution,"
-                      "transforms,build"
-                   << std::endl;
-        }
-        if (detailedBenchmark) {
-            std::string det = benchmarkOut + ".detailed.csv";
-            csvDetailedOut.open(det);
-            if (csvDetailedOut.is_open()) {
-                csvDetailedOut << "frame_index,total_ms,capture_ms,process_ms,"
-                                  "transform_ms,upload_ms,draw_ms,filter,"
-                                  "backend,resolution,transforms,build"
-                               << std::endl;
-            } else {
-                cerr << "Could not open detailed CSV '" << det
-                     << "' for writing.\n";
-            }
-        }
-    }
-    // Main Render Loop
-    while (!glfwWindowShouldClose(window)) {
-        // Start frame timer (include capture + processing + render)
-        auto tstart = std::chrono::high_resolution_clock::now();
-
-        // Capture a new frame (this is part of the timed region)
-        auto tcap_start = std::chrono::high_resolution_clock::now();
-        cap >> frame;
-        auto tcap_end = std::chrono::high_resolution_clock::now();
-
-        // Clear the screen
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-        // Check for ESC key press
-        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-            glfwSetWindowShouldClose(window, true);
-
-        // --- Handle keyboard toggles (detect on-press events) ---
-        for (size_t i = 0; i < sizeof(keysToWatch) / sizeof(keysToWatch[0]);
-             ++i) {
-            int k = keysToWatch[i];
-            bool cur = (glfwGetKey(window, k) == GLFW_PRESS);
-            if (cur && !prevKeyState[i]) {
-                // Key just pressed
-                switch (k) {
-                    case GLFW_KEY_1:
-                        setDefaultShaderOnQuad();
-                        cout << "Filter: NONE\n";
-                        currentMode = FilterMode::NONE;
-                        break;
-                    case GLFW_KEY_2:
-                        Filters::applyGrayscaleCPU(frame);
-                        setDefaultShaderOnQuad();
-                        cout << "Filter: CPU GRAY\n";
-                        currentMode = FilterMode::CPU_GRAY;
-                        break;
-                    case GLFW_KEY_3:
-                        Filters::applyCannyCPU(frame);
-                        setDefaultShaderOnQuad();
-                        cout << "Filter: CPU EDGE\n";
-                        currentMode = FilterMode::CPU_EDGE;
-                        break;
-                    case GLFW_KEY_4:
-                        Filters::applyPixelateCPU(frame);
-                        setDefaultShaderOnQuad();
-                        cout << "Filter: CPU PIXELATE\n";
-                        currentMode = FilterMode::CPU_PIXELATE;
-                        break;
-                    case GLFW_KEY_G:
-                        setGPUShaderOnQuad(Filters::gpuFragmentPathGrayscale());
-                        cout << "Filter: GPU GRAY\n";
-                        currentMode = FilterMode::GPU_GRAY;
-                        break;
-                    case GLFW_KEY_E:
-                        setGPUShaderOnQuad(Filters::gpuFragmentPathEdge());
-                        cout << "Filter: GPU EDGE\n";
-                        currentMode = FilterMode::GPU_EDGE;
-                        break;
-                    case GLFW_KEY_P:
-                        setGPUShaderOnQuad(Filters::gpuFragmentPathPixelate());
-                        cout << "Filter: GPU PIXELATE\n";
-                        currentMode = FilterMode::GPU_PIXELATE;
-                        break;
-                    case GLFW_KEY_T:
-                        g_transformsEnabled = !g_transformsEnabled;
-                        cout << "Transforms "
-                             << (g_transformsEnabled ? "ENABLED" : "DISABLED")
-                             << "\n";
-                        // If enabling GPU transforms, switch shader
-                        if (g_transformsEnabled && !g_transformsUseCPU) {
-                            setGPUShaderOnQuad(
-                                Transforms::gpuFragmentPathTransform());
-                            g_gpuTransformActive = true;
-                        } else {
-                            // disabling transforms or switching to CPU: restore
-                            // default shader
-                            if (g_gpuTransformActive) {
-                                setDefaultShaderOnQuad();
-                                g_gpuTransformActive = false;
-                            }
-                        }
-                        break;
-                    case GLFW_KEY_C:
-                        g_transformsUseCPU = !g_transformsUseCPU;
-                        cout << "Transform mode: "
-                             << (g_transformsUseCPU ? "CPU" : "GPU") << "\n";
-                        // If switching to GPU while transforms are enabled, set
-                        // GPU shader
-                        if (g_transformsEnabled && !g_transformsUseCPU) {
-                            setGPUShaderOnQuad(
-                                Transforms::gpuFragmentPathTransform());
-                            g_gpuTransformActive = true;
-                        } else {
-                            if (g_gpuTransformActive) {
-                                setDefaultShaderOnQuad();
-                                g_gpuTransformActive = false;
-                            }
-                        }
-                        break;
-                    case GLFW_KEY_R:
-                        // Reset transforms to identity
-                        g_translateU = 0.0f;
-                        g_translateV = 0.0f;
-                        g_scale = 1.0f;
-                        g_rotation = 0.0f;
-                        cout << "Transforms reset to identity\n";
-                        break;
-                }
-            }
-            prevKeyState[i] = cur;
-        }
-
-        // Update the texture with a new frame from the camera
-        double capture_ms = 0.0, proc_ms = 0.0, trans_ms = 0.0, upload_ms = 0.0;
-        if (!frame.empty() && videoTexture != nullptr) {
-            // Apply CPU filters if requested (modify frame before upload)
-            auto tproc_start = std::chrono::high_resolution_clock::now();
-            switch (currentMode) {
-                case FilterMode::CPU_GRAY:
-                    Filters::applyGrayscaleCPU(frame);
-                    break;
-                case FilterMode::CPU_EDGE:
-                    Filters::applyCannyCPU(frame);
-                    break;
-                case FilterMode::CPU_PIXELATE:
-                    Filters::applyPixelateCPU(frame);
-                    break;
-                default:
-                    // No CPU processing needed
-                    break;
-            }
-            auto tproc_end = std::chrono::high_resolution_clock::now();
-            proc_ms = std::chrono::duration_cast<
-                          std::chrono::duration<double, std::milli>>(
-                          tproc_end - tproc_start)
-                          .count();
-
-            // Apply CPU transforms if enabled and requested
-            auto ttrans_start = std::chrono::high_resolution_clock::now();
-            if (g_transformsEnabled && g_transformsUseCPU) {
-                // Convert UV-space translate/scale to pixel-space. UV +V is up,
-                // image pixel Y increases downward, so invert V when mapping
-                // to pixel-space.
-                float dx_pixels = -g_translateU * (float)frame.cols;
-                // UV +V is up, image pixel Y increases downward, so invert V
-                // when mapping to pixel-space for CPU transforms.
-                float dy_pixels = g_translateV * (float)frame.rows;
-                // Apply scale around center first, then translate
-                if (fabs(g_scale - 1.0f) > 1e-6f) {
-                    // Convert pivot UV -> pixel coordinates (frame has origin
-                    // top-left before the vertical flip applied later).
-                    // Invert U because we want to map from UV to pixel space
-                    double pivotX =
-                        (1 - (double)g_zoomPivotU) * (double)frame.cols;
-                    double pivotY = (double)g_zoomPivotV * (double)frame.rows;
-                    Transforms::applyScaleCPU(frame, g_scale, g_scale, pivotX,
-                                              pivotY);
-                }
-                // Apply rotation around center (degrees)
-                if (fabs(g_rotation) > 1e-6f) {
-                    Transforms::applyRotateCPU(frame, g_rotation);
-                }
-                if (fabs(dx_pixels) > 0.0f || fabs(dy_pixels) > 0.0f) {
-                    Transforms::applyTranslateCPU(frame, dx_pixels, dy_pixels);
-                }
-            }
-            auto ttrans_end = std::chrono::high_resolution_clock::now();
-            trans_ms = std::chrono::duration_cast<
-                           std::chrono::duration<double, std::milli>>(
-                           ttrans_end - ttrans_start)
-                           .count();
-
-            // Flip the frame vertically for OpenGL texture coordinates
-            auto tupload_start = std::chrono::high_resolution_clock::now();
-            cv::flip(frame, frame, 0);
-
-            // Upload the frame to the GPU
-            videoTexture->update(frame.data, frame.cols, frame.rows, true);
-            auto tupload_end = std::chrono::high_resolution_clock::now();
-            upload_ms = std::chrono::duration_cast<
-                            std::chrono::duration<double, std::milli>>(
-                            tupload_end - tupload_start)
-                            .count();
-
-            capture_ms = std::chrono::duration_cast<
-                             std::chrono::duration<double, std::milli>>(
-                             tcap_end - tcap_start)
-                             .count();
-        }
-
-        // Render the scene from the camera's point of view
-        // Bind the quad's shader and upload the UV transform if present
-        auto tdraw_start = std::chrono::high_resolution_clock::now();
-        myQuad->bindShaders();
-        {
-            GLint prog = 0;
-            glGetIntegerv(GL_CURRENT_PROGRAM, &prog);
-            if (prog != 0) {
-                GLint loc = glGetUniformLocation((GLuint)prog, "uTransform");
-                if (loc >= 0) {
-                    // Build a 3x3 UV transform: translate * T(center) *
-                    // S(scale) * T(-center)
-                    float cx = 0.5f, cy = 0.5f;
-                    glm::mat3 T_neg(1.0f);
-                    T_neg[2][0] = -cx;
-                    T_neg[2][1] = -cy;
-                    glm::mat3 S(1.0f);
-                    S[0][0] = g_scale;
-                    S[1][1] = g_scale;
-                    glm::mat3 T_back(1.0f);
-                    T_back[2][0] = cx;
-                    T_back[2][1] = cy;
-                    // Rotation around center (convert degrees to radians)
-                    glm::mat3 R(1.0f);
-                    float ang = glm::radians(g_rotation);
-                    float ca = std::cos(ang);
-                    float sa = std::sin(ang);
-                    // column-major: set columns accordingly
-                    R[0][0] = ca;
-                    R[0][1] = sa;
-                    R[1][0] = -sa;
-                    R[1][1] = ca;
-                    glm::mat3 T_translate(1.0f);
-                    T_translate[2][0] = g_translateU;
-                    T_translate[2][1] = g_translateV;
-                    // Compensate for the quad's aspect ratio so rotations in UV
-                    // space behave like pixel-space rotations. The quad is
-                    // created with the video aspect ratio, so X and Y are
-                    // scaled differently; to rotate without warping we scale X
-                    // by aspect, rotate, then undo the scale.
-                    float aspect = 1.0f;
-                    if (!frame.empty() && frame.rows != 0) {
-                        aspect = (float)frame.cols / (float)frame.rows;
-                    }
-                    glm::mat3 A(1.0f);     // scale X by aspect
-                    glm::mat3 Ainv(1.0f);  // inverse: scale X by 1/aspect
-                    A[0][0] = aspect;
-                    Ainv[0][0] = 1.0f / aspect;
-
-                    // Compose with aspect compensation: translate * back * Ainv
-                    // * R * S * A * T_neg
-                    glm::mat3 M =
-                        T_translate * T_back * Ainv * R * S * A * T_neg;
-                    glUniformMatrix3fv(loc, 1, GL_FALSE, &M[0][0]);
-                }
-                // Provide texel offset to shaders that sample neighbors
-                GLint locTexel =
-                    glGetUniformLocation((GLuint)prog, "texelOffset");
-                if (locTexel >= 0) {
-                    // frame.cols/rows are > 0 here (frame checked earlier)
-                    glUniform2f(locTexel, 1.0f / (float)frame.cols,
-                                1.0f / (float)frame.rows);
-                }
-                // Provide an edge threshold uniform used by GPU edge shader.
-                // When not in GPU edge mode we set it to 0.0 to preserve
-                // previous behavior (raw gradient magnitude).
-                GLint locEdge =
-                    glGetUniformLocation((GLuint)prog, "edgeThreshold");
-                if (locEdge >= 0) {
-                    float thr =
-                        (currentMode == FilterMode::GPU_EDGE) ? 0.2f : 0.0f;
-                    glUniform1f(locEdge, thr);
-                }
-            }
-        }
-        myScene->render(renderingCamera);
-
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-        auto tdraw_end = std::chrono::high_resolution_clock::now();
-
-        // End timer for this frame
-        auto tend = tdraw_end;
-        double ms =
-            std::chrono::duration_cast<
-                std::chrono::duration<double, std::milli>>(tend - tstart)
-                .count();
-
-        double draw_ms = std::chrono::duration_cast<
-                             std::chrono::duration<double, std::milli>>(
-                             tdraw_end - tdraw_start)
-                             .count();
-
-        if (doBenchmark) {
-            // Create a resolution string
-            int w = (frame.empty() ? 0 : frame.cols);
-            int h = (frame.empty() ? 0 : frame.rows);
-            std::ostringstream resos;
-            resos << w << "x" << h;
-
-            // Write either to CSV file or stdout
-            if (csvOut.is_open()) {
-                csvOut << ms << "," << frameTimesMs.size() << "," << filterArg
-                       << "," << backendArg << "," << resos.str() << ","
-                       << transformsArg << "," << buildType << "\n";
-            } else {
-                std::cout << ms << "," << frameTimesMs.size() << ","
-                          << filterArg << "," << backendArg << ","
-                          << resos.str() << "," << transformsArg << ","
-                          << buildType << std::endl;
-            }
-            if (detailedBenchmark && csvDetailedOut.is_open()) {
-                csvDetailedOut << frameTimesMs.size() << "," << ms << ","
-                               << capture_ms << "," << proc_ms << ","
-                               << trans_ms << "," << upload_ms << "," << draw_ms
-                               << "," << filterArg << "," << backendArg << ","
-                               << resos.str() << "," << transformsArg << ","
-                               << buildType << "\n";
-            }
-            frameTimesMs.push_back(ms);
-
-            if ((int)frameTimesMs.size() >= benchFrames) {
-                std::cout << "Benchmark complete: captured "
-                          << frameTimesMs.size() << " frames." << std::endl;
-                break;
-            }
-        }
-    }
-
-    // If benchmarking, emit a short summary and close CSV
-    if (doBenchmark) {
-        double sum = 0.0;
-        for (double t : frameTimesMs) sum += t;
-        double mean =
-            frameTimesMs.empty() ? 0.0 : sum / (double)frameTimesMs.size();
-        double var = 0.0;
-        for (double t : frameTimesMs) var += (t - mean) * (t - mean);
-        double stddev = frameTimesMs.size() > 1
-                            ? sqrt(var / (frameTimesMs.size() - 1))
-                            : 0.0;
-        std::cout << "Benchmark summary: frames=" << frameTimesMs.size()
-                  << ", mean_ms=" << mean << ", std_ms=" << stddev << "\n";
-        if (csvOut.is_open()) csvOut.close();
-    }
-
-    // --- Cleanup -----------------------------------------------------------
-    cout << "Closing application..." << endl;
-    cap.release();
-    delete myScene;
-    delete renderingCamera;
-    delete videoTexture;
-
-    glfwTerminate();
-    return 0;
-}
-
-/* ------------------------------------------------------------------------- */
-/* Helper: initWindow (GLFW)                                                 */
-/* ------------------------------------------------------------------------- */
-bool initWindow(std::string windowName) {
-    if (!glfwInit()) {
-        fprintf(stderr, "Failed to initialize GLFW\n");
-        return false;
-    }
-    glfwWindowHint(GLFW_SAMPLES, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-    window = glfwCreateWindow(1024, 768, windowName.c_str(), NULL, NULL);
-    if (window == NULL) {
-        fprintf(stderr, "Failed to open GLFW window.\n");
-        glfwTerminate();
-        return false;
-    }
-    glfwMakeContextCurrent(window);
-    return true;
-}
+/*
+ * OpenCV to OpenGL Exercise
+ *
+ * GOAL: Render a live video feed from a camera onto a 3D object using OpenGL.
+ *
+ * INSTRUCTIONS:
+ * This file is partially complete. Your main task is to complete the section
+ * marked "TODO" to create the initial OpenGL texture from a camera frame.
+ *
+ * The rendering loop has been completed for you as an example.
+ *
+ */
+
+#include <glad/gl.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#define GLAD_GL_IMPLEMENTATION
+
+#include <GLFW/glfw3.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+using namespace glm;
+
+#include <common/Camera.hpp>
+#include <common/ColorShader.hpp>
+#include <common/ComputeShader.hpp>
+#include <common/FramePool.hpp>
+#include <common/FrameReadback.hpp>
+#include <common/FrameUniforms.hpp>
+#include <common/GPUProfiler.hpp>
+#include <common/HeadlessContext.hpp>
+#include <common/Object.hpp>
+#include <common/PassChain.hpp>
+#include <common/PresentPacer.hpp>
+#include <common/Quad.hpp>
+#include <common/RenderTargetPool.hpp>
+#include <common/Scene.hpp>
+#include <common/Shader.hpp>
+#include <common/ShaderCache.hpp>
+#include <common/Texture.hpp>
+#include <common/TextureShader.hpp>
+#include <opencv2/opencv.hpp>
+
+#include "bench/MicroBench.hpp"
+#include "capture/CaptureThread.hpp"
+#include "capture/FrameRing.hpp"
+#include "capture/FrameSource.hpp"
+#include "capture/RawFrameFile.hpp"
+#include "filters/Filters.hpp"
+#include "filters/GPUCanny.hpp"
+#include "transforms/RemapCache.hpp"
+#include "transforms/Transforms.hpp"
+
+using namespace std;
+
+GLFWwindow* window;
+
+// Helper function to initialize the window
+bool initWindow(std::string windowName, bool visible = true);
+
+// --- Simple global transform state for mouse interaction (UV space) -----
+static bool g_isDragging = false;
+static double g_lastX = 0.0, g_lastY = 0.0;
+static float g_translateU = 0.0f, g_translateV = 0.0f;
+static float g_scale = 1.0f;
+static float g_rotation = 0.0f;  // degrees, positive = CCW
+// Transform toggles accessible from callbacks
+static bool g_transformsEnabled = false;
+static bool g_transformsUseCPU =
+    false;  // when true, apply transforms on CPU (cv::Mat)
+// When the oldest transform change not yet latched into a frame was seen
+// (by a callback, i.e. while polling); input-to-present latency is
+// measured from it.
+static bool g_inputPending = false;
+static std::chrono::steady_clock::time_point g_inputTime;
+
+// Set by SIGINT/SIGTERM: ends the render loop so the recorders and CSVs
+// are closed properly. Headless runs have no ESC key, so without
+// --benchmark this is how they stop.
+static volatile std::sig_atomic_t g_stopRequested = 0;
+
+static void requestStop(int) { g_stopRequested = 1; }
+
+static void markInput() {
+    if (g_inputPending) return;
+    g_inputPending = true;
+    g_inputTime = std::chrono::steady_clock::now();
+}
+
+// Transform parameters latched at one point of a frame, so the frame uses
+// the input as of just before the warp or draw instead of as of the end
+// of the previous frame.
+struct TransformSnapshot {
+    float translateU, translateV, scale, rotation;
+    bool dragging;
+    bool hasInput;  // folds in changes not yet latched, seen at inputTime
+    std::chrono::steady_clock::time_point inputTime;
+    double pollMs;  // time spent polling events for this snapshot
+};
+
+// Poll events (with a window) and return the time it took.
+static double pollEvents(GLFWwindow* win) {
+    if (win == nullptr) return 0.0;
+    auto start = std::chrono::steady_clock::now();
+    glfwPollEvents();
+    return std::chrono::duration<double, std::milli>(
+               std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+// Poll pending events (with a window) and take a snapshot. With `consume`
+// the changes since the last latch count as shown by this frame. Changes
+// made while transforms are off are dropped, so they do not count as
+// shown once transforms are turned on.
+static TransformSnapshot latchTransform(GLFWwindow* win, bool consume) {
+    TransformSnapshot t;
+    t.pollMs = pollEvents(win);
+    t.translateU = g_translateU;
+    t.translateV = g_translateV;
+    t.scale = g_scale;
+    t.rotation = g_rotation;
+    t.dragging = g_isDragging;
+    t.hasInput = consume && g_inputPending;
+    t.inputTime = g_inputTime;
+    if (consume || !g_transformsEnabled) g_inputPending = false;
+    return t;
+}
+
+// GLFW callbacks (defined here so they can access the static globals)
+static void scroll_callback(GLFWwindow* win, double xoffset, double yoffset) {
+    // Zoom around current cursor position
+    double mx, my;
+    int w, h;
+    glfwGetCursorPos(win, &mx, &my);
+    glfwGetWindowSize(win, &w, &h);
+    if (w <= 0 || h <= 0) return;
+    // The quad is viewed mirrored, so invert mx and my. Both backends apply
+    // the same UV transform, so this holds for CPU transforms too.
+    mx = w - mx;
+    my = h - my;
+    // Convert to UV (0..1). Note: window y is top-down so invert Y to get
+    // UV-space where V increases upwards.
+    float px = (float)(mx / (double)w);
+    float py = (float)(my / (double)h);
+
+    float oldScale = g_scale;
+    // scale exponentially for smooth zooming
+    // uTransform maps screen -> source, so a larger scale zooms out
+    float dir = -1.0f;
+    float factor = powf(1.1f, (float)yoffset * dir);
+    float newScale = oldScale * factor;
+
+    // Keep the point under cursor fixed. The shader composes scale around
+    // the image center, so we must account for the center (cx,cy).
+    // Derived: t_new = t_old + (s_old - s_new) * (p - c)
+    float s_old = oldScale;
+    float s_new = newScale;
+    float cx = 0.5f, cy = 0.5f;
+    g_translateU = g_translateU + (s_old - s_new) * (px - cx);
+    g_translateV = g_translateV + (s_old - s_new) * (py - cy);
+    g_scale = s_new;
+    markInput();
+}
+
+static void mouse_button_callback(GLFWwindow* win, int button, int action,
+                                  int mods) {
+    if (button != GLFW_MOUSE_BUTTON_LEFT) return;
+    if (action == GLFW_PRESS) {
+        g_isDragging = true;
+        glfwGetCursorPos(win, &g_lastX, &g_lastY);
+    } else if (action == GLFW_RELEASE) {
+        g_isDragging = false;
+    }
+}
+
+static void cursor_pos_callback(GLFWwindow* win, double xpos, double ypos) {
+    if (!g_isDragging) return;
+    int w, h;
+    glfwGetWindowSize(win, &w, &h);
+    if (w <= 0 || h <= 0) return;
+    double dx = xpos - g_lastX;
+    double dy = ypos - g_lastY;
+    // Convert pixel delta to UV delta. GLFW Y is top-down, so invert the
+    // vertical delta: moving the mouse up should increase V.
+    // If shift is held, interpret horizontal drag as rotation.
+    int shiftLeft = glfwGetKey(win, GLFW_KEY_LEFT_SHIFT);
+    int shiftRight = glfwGetKey(win, GLFW_KEY_RIGHT_SHIFT);
+    if (shiftLeft == GLFW_PRESS || shiftRight == GLFW_PRESS) {
+        // rotation sensitivity: degrees per pixel (tweakable)
+        const float rotSens = 0.35f;
+        g_rotation += (float)dx * rotSens;
+    } else {
+        float du = (float)(dx / (double)w);
+        float dv = (float)(dy / (double)h);
+        g_translateU += du;
+        g_translateV += dv;
+    }
+    g_lastX = xpos;
+    g_lastY = ypos;
+    markInput();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Helpers: command line                                                     */
+/* ------------------------------------------------------------------------- */
+// Numeric option values; the whole text has to parse, so "12x" or "" are
+// rejected instead of throwing or being cut short.
+static bool parseNumber(const std::string& text, int& value) {
+    char* end = nullptr;
+    long v = std::strtol(text.c_str(), &end, 10);
+    if (end == text.c_str() || *end != '\0' || v < INT_MIN || v > INT_MAX)
+        return false;
+    value = (int)v;
+    return true;
+}
+
+static bool parseNumber(const std::string& text, double& value) {
+    char* end = nullptr;
+    double v = std::strtod(text.c_str(), &end);
+    if (end == text.c_str() || *end != '\0' || !std::isfinite(v))
+        return false;
+    value = v;
+    return true;
+}
+
+static bool parseNumber(const std::string& text, float& value) {
+    double v = 0.0;
+    if (!parseNumber(text, v)) return false;
+    value = (float)v;
+    return true;
+}
+
+static void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options]\n"
+         << "  --source camera[:index]|video:<path>|images:<dir>|raw:<path>\n"
+         << "  --loop  --source-fps N  --resolution WxH  --record PATH\n"
+         << "  --benchmark  --out PATH  --frames N  --detailed\n"
+         << "  --filter none|gray|edge|canny|pixelate\n"
+         << "  --backend cpu|gpu|uber|compute  --transforms off|cpu|gpu\n"
+         << "  --translateU X  --translateV X  --scale X  --rotation DEG\n"
+         << "  --pixel-size N  --canny-thresholds LOW,HIGH\n"
+         << "  --canny-passes N  --canny-parity\n"
+         << "  --readback  --record-output PATH  --headless\n"
+         << "  --swap-interval N  --unthrottled  --pace-fps N\n"
+         << "  --microbench NAME  --iterations N  --list-permutations\n";
+}
+
+/* ------------------------------------------------------------------------- */
+/* main                                                                      */
+/* ------------------------------------------------------------------------- */
+int main(int argc, char** argv) {
+    // --- Simple CLI parsing for benchmarking -------------------------
+    bool doBenchmark = false;
+    std::string benchmarkOut = "benchmark.csv";
+    std::string filterArg = "none";  // none, gray, edge, canny, pixelate
+    std::string backendArg = "gpu";  // cpu, gpu, uber or compute (edge)
+    std::string transformsArg = "off";  // off, cpu, gpu
+    // optional initial transform values (for benchmark runs)
+    float presetTranslateU = 0.0f;
+    float presetTranslateV = 0.0f;
+    float presetScale = 1.0f;
+    float presetRotation = 0.0f;            // degrees
+    int targetWidth = 0, targetHeight = 0;  // 0 = native
+    int benchFrames = 300;
+    bool detailedBenchmark = false;
+    // Frame input: camera[:index], video:<path> or images:<dir>
+    std::string sourceArg = "camera:1";
+    bool sourceLoop = false;
+    double sourceFps = -1.0;  // <0 native/default rate, 0 unthrottled
+    std::string recordPath;   // raw container to record captured frames to
+    // Read processed frames back asynchronously (implied by
+    // --record-output, which records them like --record does the input)
+    bool readbackEnabled = false;
+    std::string recordOutputPath;
+    std::string microbenchArg;  // run a CPU kernel microbenchmark and exit
+    int microbenchIterations = 100;
+    int pixelSize = 10;  // pixelate block size, adjustable with [ and ]
+    // Canny hysteresis thresholds (CPU and GPU), scaled together with - and
+    // =
+    double cannyLow = 50.0, cannyHigh = 150.0;
+    int cannyPasses = 0;       // GPU Canny hysteresis pass cap, 0 = auto
+    bool cannyParity = false;  // compare the GPU Canny with the CPU one
+    bool listPermutations = false;  // print the uber-shader set and exit
+    // No window: EGL surfaceless (or a hidden GLFW window) rendering into
+    // a frame-sized FBO, and no swap/event polling in the frame time
+    bool headless = false;
+    // Presentation: vsync interval for glfwSwapBuffers (-1 keeps the
+    // driver's default), --unthrottled (interval 0 unless given, and the
+    // swap outside the frame time) and a fixed present rate (0 = off)
+    int swapInterval = -1;
+    bool unthrottled = false;
+    double paceFps = 0.0;
+
+    // Malformed values are reported and end the run after the usage text.
+    bool badArguments = false;
+    auto number = [&](const std::string& flag, const std::string& text,
+                      auto& value) {
+        if (parseNumber(text, value)) return;
+        cerr << "Invalid value '" << text << "' for " << flag << "\n";
+        badArguments = true;
+    };
+
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--benchmark")
+            doBenchmark = true;
+        else if (a == "--out" && i + 1 < argc)
+            benchmarkOut = argv[++i];
+        else if (a == "--filter" && i + 1 < argc)
+            filterArg = argv[++i];
+        else if (a == "--backend" && i + 1 < argc)
+            backendArg = argv[++i];
+        else if (a == "--transforms" && i + 1 < argc)
+            transformsArg = argv[++i];
+        else if (a == "--translateU" && i + 1 < argc)
+            number(a, argv[++i], presetTranslateU);
+        else if (a == "--translateV" && i + 1 < argc)
+            number(a, argv[++i], presetTranslateV);
+        else if (a == "--scale" && i + 1 < argc)
+            number(a, argv[++i], presetScale);
+        else if (a == "--rotation" && i + 1 < argc)
+            number(a, argv[++i], presetRotation);
+        else if (a == "--resolution" && i + 1 < argc) {
+            std::string res = argv[++i];
+            size_t x = res.find('x');
+            if (x == std::string::npos) {
+                cerr << "Invalid value '" << res << "' for " << a << "\n";
+                badArguments = true;
+            } else {
+                number(a, res.substr(0, x), targetWidth);
+                number(a, res.substr(x + 1), targetHeight);
+            }
+        } else if (a == "--frames" && i + 1 < argc) {
+            number(a, argv[++i], benchFrames);
+        } else if (a == "--detailed") {
+            detailedBenchmark = true;
+        } else if (a == "--source" && i + 1 < argc) {
+            sourceArg = argv[++i];
+        } else if (a == "--loop") {
+            sourceLoop = true;
+        } else if (a == "--source-fps" && i + 1 < argc) {
+            number(a, argv[++i], sourceFps);
+        } else if (a == "--record" && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (a == "--readback") {
+            readbackEnabled = true;
+        } else if (a == "--record-output" && i + 1 < argc) {
+            recordOutputPath = argv[++i];
+            readbackEnabled = true;
+        } else if (a == "--microbench" && i + 1 < argc) {
+            microbenchArg = argv[++i];
+        } else if (a == "--iterations" && i + 1 < argc) {
+            number(a, argv[++i], microbenchIterations);
+        } else if (a == "--pixel-size" && i + 1 < argc) {
+            number(a, argv[++i], pixelSize);
+            pixelSize = std::max(1, pixelSize);
+        } else if (a == "--list-permutations") {
+            listPermutations = true;
+        } else if (a == "--headless") {
+            headless = true;
+        } else if (a == "--swap-interval" && i + 1 < argc) {
+            number(a, argv[++i], swapInterval);
+            swapInterval = std::max(0, swapInterval);
+        } else if (a == "--unthrottled") {
+            unthrottled = true;
+        } else if (a == "--pace-fps" && i + 1 < argc) {
+            number(a, argv[++i], paceFps);
+            paceFps = std::max(0.0, paceFps);
+        } else if (a == "--canny-thresholds" && i + 1 < argc) {
+            std::string t = argv[++i];
+            size_t comma = t.find(',');
+            if (comma == std::string::npos) {
+                cerr << "Invalid value '" << t << "' for " << a << "\n";
+                badArguments = true;
+            } else {
+                number(a, t.substr(0, comma), cannyLow);
+                number(a, t.substr(comma + 1), cannyHigh);
+            }
+        } else if (a == "--canny-passes" && i + 1 < argc) {
+            number(a, argv[++i], cannyPasses);
+            cannyPasses = std::max(0, cannyPasses);
+        } else if (a == "--canny-parity") {
+            cannyParity = true;
+        }
+    }
+    if (badArguments) {
+        printUsage(argv[0]);
+        return -1;
+    }
+    // One "<filter> <transforms>" line per uber-shader permutation, in the
+    // --filter / --transforms spelling, for benchmark sweeps.
+    if (listPermutations) {
+        for (const Filters::GPUPermutation& p : Filters::gpuUberPermutations())
+            cout << p.filter << " " << (p.transform ? "gpu" : "off") << "\n";
+        return 0;
+    }
+    // Microbenchmarks run on synthetic frames: no source, no window.
+    if (!microbenchArg.empty())
+        return MicroBench::run(microbenchArg, microbenchIterations);
+
+    // Open frame source
+    FrameSource* source = createFrameSource(sourceArg, sourceLoop, sourceFps);
+    if (source == nullptr) {
+        cerr << "Error: Unknown source '" << sourceArg << "'." << endl;
+        printUsage(argv[0]);
+        return -1;
+    }
+    if (!source->isOpened()) {
+        cerr << "Error: Could not open " << source->describe() << ". Exiting."
+             << endl;
+        delete source;
+        return -1;
+    }
+    cout << "Opened " << source->describe() << endl;
+
+    // Initialize OpenGL context. Headless runs try EGL first, which needs
+    // no display server; a hidden window still needs one.
+    HeadlessContext headlessContext;
+    int version = 0;
+    if (headless && headlessContext.create()) {
+        window = nullptr;
+        cout << "Headless: " << headlessContext.description() << endl;
+        version = gladLoadGL((GLADloadfunc)HeadlessContext::procAddress);
+    } else {
+        if (headless)
+            cout << "Headless: no EGL context (" << headlessContext.error()
+                 << "), using a hidden window" << endl;
+        if (!initWindow("Webcam", !headless)) {
+            delete source;
+            return -1;
+        }
+        version = gladLoadGL(glfwGetProcAddress);
+    }
+    if (version == 0) {
+        fprintf(stderr, "Failed to initialize OpenGL context (GLAD)\n");
+        delete source;
+        return -1;
+    }
+    cout << "Loaded OpenGL " << GLAD_VERSION_MAJOR(version) << "."
+         << GLAD_VERSION_MINOR(version) << "\n";
+
+    // Basic OpenGL setup
+    if (window != nullptr) {
+        glfwSetInputMode(window, GLFW_STICKY_KEYS, GL_TRUE);
+        // Install mouse/scroll callbacks for interactive transforms
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetMouseButtonCallback(window, mouse_button_callback);
+        glfwSetCursorPosCallback(window, cursor_pos_callback);
+        // With the default interval of 1 every swap waits for vsync, which
+        // caps frame times at the refresh rate.
+        if (unthrottled && swapInterval < 0) swapInterval = 0;
+        if (swapInterval >= 0) glfwSwapInterval(swapInterval);
+    }
+    glClearColor(0.1f, 0.1f, 0.2f, 0.0f);  // A dark blue background
+    glEnable(GL_DEPTH_TEST);
+
+    GLuint VertexArrayID;
+    glGenVertexArrays(1, &VertexArrayID);
+    glBindVertexArray(VertexArrayID);
+
+    // Prepare Scene, Shaders, and Objects
+
+    // We get one frame from the source to determine its size.
+    cv::Mat frame;
+    source->read(frame);
+    if (frame.empty()) {
+        cerr << "Error: couldn't capture an initial frame from "
+             << source->describe() << ". Exiting.\n";
+        delete source;
+        glfwTerminate();
+        return -1;
+    }
+
+    // Shader builds run in the background: on the driver's own threads if
+    // it can compile in parallel, otherwise on a hidden window sharing
+    // objects with the main one (EGL runs without one build synchronously).
+    GLFWwindow* compileContext = nullptr;
+    if (!ShaderCache::parallelCompileSupported() && window != nullptr) {
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+        compileContext = glfwCreateWindow(1, 1, "", NULL, window);
+    }
+    ShaderCache* shaderCache = new ShaderCache("shader_cache", compileContext);
+    FrameUniforms* frameUniforms = new FrameUniforms();
+    // Processed frames for CPU consumers, delivered a frame or two late.
+    FrameReadback* readback = readbackEnabled ? new FrameReadback(3) : nullptr;
+    // GPU time of the upload, each pass and the final draw, read three
+    // frames late so it never waits for the GPU.
+    GPUProfiler* gpuProfiler = new GPUProfiler(3);
+
+    // Compute-shader edge filter, next to the fragment version, when the
+    // context has OpenGL 4.3.
+    ComputeShader* edgeCompute = nullptr;
+    if (ComputeShader::supported()) {
+        edgeCompute = new ComputeShader("gpu_edge.comp");
+        if (!edgeCompute->valid()) {
+            delete edgeCompute;
+            edgeCompute = nullptr;
+        }
+    }
+
+    // Multi-pass GPU Canny; its programs build in the background like the
+    // ones below.
+    Filters::GPUCanny* gpuCanny =
+        new Filters::GPUCanny(*shaderCache, cannyPasses);
+    gpuCanny->prepare(false);
+
+    // Start every filter/transform program up front (or load it from the
+    // on-disk binary cache); switching filters then only swaps shader
+    // pointers. Filters can also run as intermediate passes ahead of the
+    // GPU transform, so they are built for both vertex shaders. Only the
+    // default program is waited for.
+    const std::string quadFragments[] = {
+        Filters::gpuFragmentPathGrayscale(), Filters::gpuFragmentPathEdge(),
+        Filters::gpuFragmentPathPixelate(),
+        Filters::gpuFragmentPathPixelateReduce(),
+        Transforms::gpuFragmentPathTransform()};
+    for (const std::string& fragPath : quadFragments) {
+        shaderCache->request("videoTextureShader.vert", fragPath);
+        shaderCache->request("fullscreenPass.vert", fragPath);
+    }
+
+    // Create objects needed for rendering.
+    TextureShader* textureShader =
+        shaderCache->get("videoTextureShader.vert", "videoTextureShader.frag");
+    if (textureShader == nullptr) {
+        // Typically the shader files are not in the working directory.
+        cerr << "Error: couldn't build the default shader program "
+                "(videoTextureShader.vert/.frag). Exiting.\n";
+        delete gpuCanny;
+        delete edgeCompute;
+        delete gpuProfiler;
+        delete readback;
+        delete frameUniforms;
+        delete shaderCache;
+        if (compileContext != nullptr) glfwDestroyWindow(compileContext);
+        delete source;
+        headlessContext.destroy();
+        glfwTerminate();
+        return -1;
+    }
+    cout << "Shader programs: " << shaderCache->builtFromSource()
+         << " compiled, " << shaderCache->loadedFromBinary()
+         << " loaded from cache, " << shaderCache->pending()
+         << " building (" << shaderCache->asyncMode() << ")" << endl;
+    Scene* myScene = new Scene();
+    Camera* renderingCamera = new Camera();
+    renderingCamera->setPosition(glm::vec3(0, 0, -2.5));
+
+    // Calculate aspect ratio and create a quad with the correct dimensions.
+    float videoAspectRatio = (float)frame.cols / (float)frame.rows;
+    Quad* myQuad = new Quad(videoAspectRatio);
+    myQuad->setShader(textureShader, false);
+    myScene->addObject(myQuad);
+
+    // This variable will hold our OpenGL texture.
+    Texture* videoTexture = nullptr;
+
+    // Frames upload top-down as they are; the shaders flip V when sampling.
+    videoTexture = new Texture();
+    videoTexture->update(frame.data, frame.cols, frame.rows, true,
+                         frame.channels(), frame.step);
+
+    // We must tell the shader which texture to use.
+    textureShader->setTexture(videoTexture);
+
+    // If user requested a target resolution, set capture properties now.
+    if (targetWidth > 0 && targetHeight > 0) {
+        source->setResolution(targetWidth, targetHeight);
+        cout << "Requested source resolution: " << targetWidth << "x"
+             << targetHeight << endl;
+        // Re-query an initial frame at new resolution
+        source->read(frame);
+        if (!frame.empty()) {
+            videoTexture->update(frame.data, frame.cols, frame.rows, true,
+                                 frame.channels(), frame.step);
+        }
+    }
+
+    // Hand the source over to the capture thread. From here on only the
+    // producer touches `source`; the render loop takes frames from the ring.
+    FrameRing frameRing(3);
+    frameRing.preallocate(frame.size(), frame.type());
+    CaptureThread captureThread(*source, frameRing);
+    RawFrameWriter recorder;
+    if (!recordPath.empty()) {
+        if (recorder.open(recordPath, frame.size(), frame.type())) {
+            captureThread.setRecorder(&recorder);
+            cout << "Recording raw frames to " << recordPath << endl;
+        }
+    }
+    captureThread.start();
+
+    // Consumer of the read-back frames: a raw recording of the output. It
+    // is opened with the size of the first frame that comes back.
+    RawFrameWriter outputRecorder;
+    if (readback != nullptr && !recordOutputPath.empty()) {
+        readback->addConsumer([&](const cv::Mat& out, int64_t) {
+            if (recordOutputPath.empty()) return;
+            if (!outputRecorder.isOpen()) {
+                if (!outputRecorder.open(recordOutputPath, out.size(),
+                                         out.type())) {
+                    recordOutputPath.clear();
+                    return;
+                }
+                cout << "Recording processed frames to " << recordOutputPath
+                     << endl;
+            }
+            outputRecorder.append(out);
+        });
+    }
+
+    // Scratch buffers for the CPU filters and transforms.
+    // CPU stages never write into their input, so zero-copy source frames
+    // can be processed directly.
+    FramePool framePool;
+    // Canny scratch (per-band buffers) for the CPU edge filter, kept
+    // between frames like the pool's.
+    Filters::CannyEngine cannyEngine;
+    // Remap tables for the CPU transform, rebuilt when the parameters change
+    RemapCache remapCache;
+
+    // If benchmarking was requested, configure filters/transforms accordingly
+    std::ofstream csvOut;
+    std::ofstream csvDetailedOut;
+    std::vector<double> frameTimesMs;
+    std::string buildType =
+#ifdef NDEBUG
+        "Release";
+#else
+        "Debug";
+#endif
+
+    // (Benchmark configuration that needs runtime symbols is done later
+    // after shader helper lambdas and FilterMode are declared.)
+
+    // Keys we watch for toggles (kept for backwards compatibility)
+    // Add T = toggle transforms on/off, C = toggle CPU/GPU transform mode
+    // [ / ] = shrink / grow the pixelate block size (CPU and GPU)
+    // - / = = lower / raise the Canny thresholds (CPU and GPU)
+    // N = GPU Canny (multi-pass, matches the CPU edge filter)
+    // K = GPU edge as a compute shader (OpenGL 4.3)
+    // U = fuse GPU filter + transform into one uber-shader pass (or chain)
+    const int keysToWatch[] = {GLFW_KEY_1, GLFW_KEY_2, GLFW_KEY_3, GLFW_KEY_4,
+                               GLFW_KEY_G, GLFW_KEY_E, GLFW_KEY_P, GLFW_KEY_T,
+                               GLFW_KEY_C, GLFW_KEY_R, GLFW_KEY_LEFT_BRACKET,
+                               GLFW_KEY_RIGHT_BRACKET, GLFW_KEY_MINUS,
+                               GLFW_KEY_EQUAL, GLFW_KEY_U, GLFW_KEY_K,
+                               GLFW_KEY_N};
+    bool prevKeyState[sizeof(keysToWatch) / sizeof(keysToWatch[0])] = {false};
+
+    // Transform toggles
+    // (moved to file-level globals so callbacks can see them)
+
+    // GPU work runs as a chain of fragment passes: the GPU filter (if
+    // any) into a pooled render target, then the GPU transform (if on)
+    // drawn through the quad. With a single pass nothing goes through a
+    // render target.
+    RenderTargetPool renderTargets;
+    PassChain passChain(renderTargets, gpuProfiler);
+
+    // Headless runs draw the quad into a frame-sized target instead of a
+    // window (an EGL context has no default framebuffer at all). It stays
+    // bound; the passes restore it after drawing into their own targets.
+    RenderTarget* headlessTarget = nullptr;
+    if (headless) {
+        headlessTarget =
+            renderTargets.acquire(frame.cols, frame.rows, GL_RGBA8);
+        glBindFramebuffer(GL_FRAMEBUFFER, headlessTarget->framebuffer);
+        glViewport(0, 0, frame.cols, frame.rows);
+        cout << "Rendering offscreen at " << frame.cols << "x" << frame.rows
+             << endl;
+    }
+    struct GPUPass {
+        std::string name;
+        std::string fragment;
+        GLenum format;  // render target format when not the last pass
+        std::vector<std::string> defines;
+        ComputeShader* compute = nullptr;  // instead of `fragment`
+        int divisor = 1;  // render target size = source size / divisor
+        PassStage* stage = nullptr;  // multi-pass stage, instead of both
+    };
+    // Instead of chaining, fuse filter and transform into one uber-shader
+    // permutation (--backend uber, U key).
+    bool useUberShader = false;
+
+    // Make variables to track current filter
+    enum class FilterMode {
+        NONE,
+        CPU_GRAY,
+        CPU_EDGE,
+        CPU_PIXELATE,
+        GPU_GRAY,
+        GPU_EDGE,
+        GPU_EDGE_COMPUTE,
+        GPU_CANNY,
+        GPU_PIXELATE
+    };
+    // Keys and --filter set the requested mode; the frame loop runs the
+    // current one. A request only takes effect when applyPendingPasses()
+    // installs the chain built for it, so the CPU stages and the GPU passes
+    // switch on the same frame. Where the transform runs (CPU warp or GPU
+    // pass) switches along with them.
+    FilterMode requestedMode = FilterMode::NONE;
+    FilterMode pendingMode = FilterMode::NONE;
+    FilterMode currentMode = FilterMode::NONE;
+    bool pendingCPUTransform = false, pendingGPUTransform = false;
+    bool cpuTransform = false, gpuTransform = false;
+
+    // Mode/transform changes go through pendingPasses: the quad keeps the
+    // current chain until every program of the new one has finished
+    // linking, then the chain is swapped between two frames. The cache
+    // keeps ownership. With `wait` the builds are finished on the spot
+    // (used before benchmark timing starts).
+    std::vector<GPUPass> pendingPasses;
+    auto applyPendingPasses = [&](bool wait) {
+        if (pendingPasses.empty()) return;
+        std::vector<TextureShader*> shaders;
+        bool ready = true;
+        for (size_t i = 0; i < pendingPasses.size(); ++i) {
+            if (pendingPasses[i].compute != nullptr) {
+                shaders.push_back(nullptr);  // built at startup
+                continue;
+            }
+            if (pendingPasses[i].stage != nullptr) {
+                shaders.push_back(nullptr);
+                PassStage* stage = pendingPasses[i].stage;
+                bool built = stage->prepare(wait);
+                if (!built && stage->failed()) {
+                    cerr << "Pass " << pendingPasses[i].name
+                         << " failed to build; keeping the current one.\n";
+                    pendingPasses.clear();
+                    return;
+                }
+                ready = ready && built;
+                continue;
+            }
+            const char* vert = (i + 1 == pendingPasses.size())
+                                   ? "videoTextureShader.vert"
+                                   : "fullscreenPass.vert";
+            const std::string& frag = pendingPasses[i].fragment;
+            const std::vector<std::string>& defines =
+                pendingPasses[i].defines;
+            TextureShader* sh = wait ? shaderCache->get(vert, frag, defines)
+                                     : shaderCache->request(vert, frag,
+                                                            defines);
+            if (sh == nullptr &&
+                (wait || !shaderCache->building(vert, frag, defines))) {
+                cerr << "Shader " << frag
+                     << " failed to build; keeping the current one.\n";
+                pendingPasses.clear();
+                return;
+            }
+            ready = ready && sh != nullptr;
+            shaders.push_back(sh);
+        }
+        if (!ready) return;
+        passChain.clear();
+        for (size_t i = 0; i < shaders.size(); ++i) {
+            if (pendingPasses[i].compute != nullptr)
+                passChain.addComputePass(pendingPasses[i].name,
+                                         pendingPasses[i].compute,
+                                         pendingPasses[i].format);
+            else if (pendingPasses[i].stage != nullptr)
+                passChain.addStage(pendingPasses[i].name,
+                                   pendingPasses[i].stage);
+            else
+                passChain.addPass(pendingPasses[i].name, shaders[i],
+                                  pendingPasses[i].format,
+                                  pendingPasses[i].divisor);
+        }
+        pendingPasses.clear();
+        currentMode = pendingMode;
+        cpuTransform = pendingCPUTransform;
+        gpuTransform = pendingGPUTransform;
+    };
+
+    cout << "Filter keys: 1=None, 2=CPU Gray, 3=CPU Edge, 4=CPU Pixelate, "
+            "G=GPU Gray, E=GPU Edge, P=GPU Pixelate, [/]=Pixel size, "
+            "-/==Edge thresholds, K=Compute GPU Edge, N=GPU Canny, "
+            "U=Fused uber-shader on/off"
+         << endl;
+
+    // Rebuild the pass list from the requested filter mode and transform
+    // toggles.
+    auto requestGPUPasses = [&](void) {
+        std::vector<GPUPass> passes;
+        pendingMode = requestedMode;
+        pendingCPUTransform = g_transformsEnabled && g_transformsUseCPU;
+        pendingGPUTransform = g_transformsEnabled && !g_transformsUseCPU;
+        // The compute edge and Canny passes have no uber-shader version.
+        if (useUberShader && requestedMode != FilterMode::GPU_EDGE_COMPUTE &&
+            requestedMode != FilterMode::GPU_CANNY) {
+            Filters::GPUPermutation p;
+            p.filter =
+                requestedMode == FilterMode::GPU_GRAY       ? "gray"
+                : requestedMode == FilterMode::GPU_EDGE     ? "edge"
+                : requestedMode == FilterMode::GPU_PIXELATE ? "pixelate"
+                                                            : "none";
+            p.transform = pendingGPUTransform;
+            // Pixelate needs its block means first; the uber pass fuses
+            // the expansion with the transform.
+            if (p.filter == "pixelate")
+                passes.push_back({"pixelate-reduce",
+                                  Filters::gpuFragmentPathPixelateReduce(),
+                                  GL_RGBA8, {}, nullptr, pixelSize});
+            passes.push_back({"uber:" + p.name(),
+                              Filters::gpuFragmentPathUber(), GL_RGBA8,
+                              p.defines()});
+            if (readback != nullptr)
+                passes.push_back(
+                    {"copy", "videoTextureShader.frag", GL_RGBA8, {}});
+            pendingPasses = passes;
+            applyPendingPasses(false);
+            return;
+        }
+        switch (requestedMode) {
+            case FilterMode::GPU_GRAY:
+                passes.push_back(
+                    {"gray", Filters::gpuFragmentPathGrayscale(), GL_R8, {}});
+                break;
+            case FilterMode::GPU_EDGE:
+                passes.push_back(
+                    {"edge", Filters::gpuFragmentPathEdge(), GL_R8, {}});
+                break;
+            case FilterMode::GPU_EDGE_COMPUTE:
+                // Writes an image, so something has to draw it: the
+                // transform or the copy pass below.
+                passes.push_back({"edge-compute", "", GL_R8, {}, edgeCompute});
+                break;
+            case FilterMode::GPU_CANNY:
+                passes.push_back(
+                    {"canny", "", GL_R8, {}, nullptr, 1, gpuCanny});
+                break;
+            case FilterMode::GPU_PIXELATE:
+                // Exact block means into a 1/pixelSize target, then a
+                // nearest-neighbour expansion.
+                passes.push_back({"pixelate-reduce",
+                                  Filters::gpuFragmentPathPixelateReduce(),
+                                  GL_RGBA8, {}, nullptr, pixelSize});
+                passes.push_back({"pixelate",
+                                  Filters::gpuFragmentPathPixelate(),
+                                  GL_RGBA8, {}});
+                break;
+            default:
+                break;
+        }
+        if (pendingGPUTransform)
+            passes.push_back({"transform",
+                              Transforms::gpuFragmentPathTransform(),
+                              GL_RGBA8, {}});
+        // Readback needs the result in a render target: the last real pass
+        // (or a copy of the frame) renders into one and a copy draws it.
+        if (readback != nullptr && passes.empty())
+            passes.push_back(
+                {"copy", "videoTextureShader.frag", GL_RGBA8, {}});
+        if (readback != nullptr || passes.empty() ||
+            passes.back().compute != nullptr ||
+            passes.back().stage != nullptr)
+            passes.push_back(
+                {"copy", "videoTextureShader.frag", GL_RGBA8, {}});
+        pendingPasses = passes;
+        applyPendingPasses(false);
+    };
+    requestGPUPasses();
+
+    // If benchmarking was requested, configure filters/transforms accordingly
+    if (doBenchmark) {
+        cout << "Running in BENCHMARK mode -> " << benchmarkOut << "\n";
+        std::string fa = filterArg;
+        for (auto& c : fa) c = (char)tolower(c);
+        std::string be = backendArg;
+        for (auto& c : be) c = (char)tolower(c);
+        useUberShader = (be == "uber");
+
+        if (fa == "none") {
+            requestedMode = FilterMode::NONE;
+        } else if (fa == "gray") {
+            if (be == "cpu") {
+                requestedMode = FilterMode::CPU_GRAY;
+            } else {
+                requestedMode = FilterMode::GPU_GRAY;
+            }
+        } else if (fa == "edge") {
+            if (be == "cpu") {
+                requestedMode = FilterMode::CPU_EDGE;
+            } else if (be == "compute" && edgeCompute != nullptr) {
+                requestedMode = FilterMode::GPU_EDGE_COMPUTE;
+            } else {
+                if (be == "compute")
+                    cout << "Compute shaders unavailable (need OpenGL 4.3); "
+                            "using the fragment edge filter\n";
+                requestedMode = FilterMode::GPU_EDGE;
+            }
+        } else if (fa == "canny") {
+            // The CPU edge filter is Canny already; on the GPU this picks
+            // the multi-pass version instead of the Sobel shader.
+            if (be == "cpu") {
+                requestedMode = FilterMode::CPU_EDGE;
+            } else {
+                requestedMode = FilterMode::GPU_CANNY;
+            }
+        } else if (fa == "pixelate") {
+            if (be == "cpu") {
+                requestedMode = FilterMode::CPU_PIXELATE;
+            } else {
+                requestedMode = FilterMode::GPU_PIXELATE;
+            }
+        } else {
+            cout << "Unknown filter name '" << filterArg
+                 << "', defaulting to none\n";
+            requestedMode = FilterMode::NONE;
+        }
+
+        // Transforms argument: off, cpu, gpu
+        if (transformsArg == "cpu") {
+            g_transformsEnabled = true;
+            g_transformsUseCPU = true;
+        } else if (transformsArg == "gpu") {
+            g_transformsEnabled = true;
+            g_transformsUseCPU = false;
+        } else {
+            g_transformsEnabled = false;
+            g_transformsUseCPU = false;
+        }
+
+        // If transforms are enabled for the benchmark, apply any preset
+        // transform values provided on the CLI so the run exercises
+        // non-identity transforms.
+        if (g_transformsEnabled) {
+            g_translateU = presetTranslateU;
+            g_translateV = presetTranslateV;
+            g_scale = presetScale;
+            g_rotation = presetRotation;
+        }
+
+        // Open CSV for writing
+        csvOut.open(benchmarkOut);
+        if (!csvOut.is_open()) {
+            cerr << "Could not open output CSV '" << benchmarkOut
+                 << "' for writing. Will print to stdout instead.\n";
+        } else {
+            csvOut << "frame_ms,frame_index,filter,backend,resolution,"
+                      "transforms,build"
+                   << std::endl;
+        }
+        if (detailedBenchmark) {
+            std::string det = benchmarkOut + ".detailed.csv";
+            csvDetailedOut.open(det);
+            if (!csvDetailedOut.is_open()) {
+                cerr << "Could not open detailed CSV '" << det
+                     << "' for writing.\n";
+            }
+        }
+    }
+    // Timed frames must not start on the previous chain.
+    requestGPUPasses();
+    applyPendingPasses(true);
+
+    // Profiler sections with a CSV column each ("gpu_<name>_ms"): the
+    // upload, the passes of the chain the run starts with, the draw.
+    std::vector<std::string> gpuSections = passChain.timerNames();
+    gpuSections.insert(gpuSections.begin(), "upload");
+    gpuSections.push_back("draw");
+    if (csvDetailedOut.is_open()) {
+        csvDetailedOut << "frame_index,total_ms,capture_ms,process_ms,"
+                          "transform_ms,upload_ms,draw_ms,filter,"
+                          "backend,resolution,transforms,build,"
+                          "ring_occupancy,ring_dropped,ring_skipped,"
+                          "stale_iterations,producer_capture_ms,"
+                          "producer_frames,pool_hits,pool_misses,"
+                          "remap_hits,remap_misses,remap_hit_rate,"
+                          "gpu_passes,readback_latency_ms,"
+                          "readback_latency_frames,readback_mb_s,"
+                          "present_interval_ms,deadline_missed,"
+                          "input_to_present_ms";
+        for (const std::string& name : gpuSections) {
+            std::string column = name;
+            std::replace_if(
+                column.begin(), column.end(),
+                [](char c) { return !std::isalnum((unsigned char)c); }, '_');
+            csvDetailedOut << ",gpu_" << column << "_ms";
+        }
+        csvDetailedOut << std::endl;
+    }
+
+    // Render iterations since the last fresh frame (producer-bound loops
+    // show up as a growing count here).
+    int staleIterations = 0;
+    // Index of the next frame handed to the readback.
+    int64_t readbackIndex = 0;
+
+    // --canny-parity totals: frames compared, pixels differing from the CPU
+    // filter, the worst frame's fraction and frames that hit the pass cap.
+    int parityFrames = 0, parityCapped = 0;
+    long long parityMismatched = 0, parityPixels = 0;
+    double parityWorst = 0.0;
+
+    // Present-to-present intervals, and with --pace-fps the frame slots
+    // and deadline misses.
+    PresentPacer presentPacer(paceFps > 0.0 ? 1000.0 / paceFps : 0.0);
+
+    // Events are polled right before the transform is used (see
+    // latchTransform()); none without a window.
+    GLFWwindow* inputWindow = headless ? nullptr : window;
+    // Input-to-present latency of frames showing new transform input.
+    int64_t inputSamples = 0;
+    double inputLatencySum = 0.0, inputLatencyMax = 0.0;
+
+    std::signal(SIGINT, requestStop);
+    std::signal(SIGTERM, requestStop);
+
+    // Main Render Loop
+    while (!g_stopRequested &&
+           (headless || !glfwWindowShouldClose(window))) {
+        // Paced runs wait for the frame's slot first; the wait is idle
+        // time, not part of the frame.
+        presentPacer.beginFrame();
+
+        // Start frame timer (include capture + processing + render)
+        auto tstart = std::chrono::high_resolution_clock::now();
+        gpuProfiler->beginFrame();
+
+        // Take the newest captured frame without blocking. The slot stays
+        // ours until release().
+        auto tcap_start = std::chrono::high_resolution_clock::now();
+        cv::Mat* captured = frameRing.acquireLatest();
+        bool freshFrame = (captured != nullptr);
+        if (freshFrame) {
+            frame = *captured;
+        } else {
+            ++staleIterations;
+            // A finite replay has been fully consumed.
+            if (captureThread.finished() && frameRing.occupancy() == 0) {
+                cout << "Source exhausted." << endl;
+                break;
+            }
+        }
+        size_t ringOccupancy = frameRing.occupancy();
+        auto tcap_end = std::chrono::high_resolution_clock::now();
+
+        // Clear the screen
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // Keys and window events. Transform input is picked up again when
+        // it is latched, just before the warp or the draw. Unthrottled runs
+        // leave all polling out of the frame, transform and draw times.
+        double framePollMs = pollEvents(inputWindow);
+        double transformPollMs = 0.0, drawPollMs = 0.0;
+        // Oldest transform input this frame shows, if any.
+        bool frameHasInput = false;
+        std::chrono::steady_clock::time_point frameInputTime;
+        auto showInput = [&](const TransformSnapshot& t) {
+            if (!t.hasInput || (frameHasInput && frameInputTime < t.inputTime))
+                return;
+            frameHasInput = true;
+            frameInputTime = t.inputTime;
+        };
+
+        // Check for ESC key press
+        if (!headless && glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, true);
+
+        // --- Handle keyboard toggles (detect on-press events) ---
+        // (none without a window: headless runs are configured on the
+        // command line)
+        for (size_t i = 0;
+             !headless && i < sizeof(keysToWatch) / sizeof(keysToWatch[0]);
+             ++i) {
+            int k = keysToWatch[i];
+            bool cur = (glfwGetKey(window, k) == GLFW_PRESS);
+            if (cur && !prevKeyState[i]) {
+                // Key just pressed
+                switch (k) {
+                    case GLFW_KEY_1:
+                        cout << "Filter: NONE\n";
+                        requestedMode = FilterMode::NONE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_2:
+                        cout << "Filter: CPU GRAY\n";
+                        requestedMode = FilterMode::CPU_GRAY;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_3:
+                        cout << "Filter: CPU EDGE\n";
+                        requestedMode = FilterMode::CPU_EDGE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_4:
+                        cout << "Filter: CPU PIXELATE\n";
+                        requestedMode = FilterMode::CPU_PIXELATE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_G:
+                        cout << "Filter: GPU GRAY\n";
+                        requestedMode = FilterMode::GPU_GRAY;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_E:
+                        cout << "Filter: GPU EDGE\n";
+                        requestedMode = FilterMode::GPU_EDGE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_K:
+                        if (edgeCompute == nullptr) {
+                            cout << "Compute shaders unavailable (need "
+                                    "OpenGL 4.3)\n";
+                            break;
+                        }
+                        cout << "Filter: GPU EDGE (compute)\n";
+                        requestedMode = FilterMode::GPU_EDGE_COMPUTE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_N:
+                        cout << "Filter: GPU CANNY\n";
+                        requestedMode = FilterMode::GPU_CANNY;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_P:
+                        cout << "Filter: GPU PIXELATE\n";
+                        requestedMode = FilterMode::GPU_PIXELATE;
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_T:
+                        g_transformsEnabled = !g_transformsEnabled;
+                        cout << "Transforms "
+                             << (g_transformsEnabled ? "ENABLED" : "DISABLED")
+                             << "\n";
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_C:
+                        g_transformsUseCPU = !g_transformsUseCPU;
+                        cout << "Transform mode: "
+                             << (g_transformsUseCPU ? "CPU" : "GPU") << "\n";
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_U:
+                        useUberShader = !useUberShader;
+                        cout << "GPU path: "
+                             << (useUberShader ? "uber-shader" : "pass chain")
+                             << "\n";
+                        requestGPUPasses();
+                        break;
+                    case GLFW_KEY_R:
+                        // Reset transforms to identity
+                        g_translateU = 0.0f;
+                        g_translateV = 0.0f;
+                        g_scale = 1.0f;
+                        g_rotation = 0.0f;
+                        markInput();
+                        cout << "Transforms reset to identity\n";
+                        break;
+                    case GLFW_KEY_LEFT_BRACKET:
+                    case GLFW_KEY_RIGHT_BRACKET:
+                        pixelSize += (k == GLFW_KEY_RIGHT_BRACKET) ? 1 : -1;
+                        pixelSize = std::max(1, std::min(pixelSize, 64));
+                        cout << "Pixel size: " << pixelSize << "\n";
+                        // The GPU reduction target is sized by it.
+                        if (requestedMode == FilterMode::GPU_PIXELATE)
+                            requestGPUPasses();
+                        break;
+                    case GLFW_KEY_MINUS:
+                    case GLFW_KEY_EQUAL: {
+                        // Scale both so the low:high ratio is kept
+                        double f = (k == GLFW_KEY_EQUAL) ? 1.1 : 1.0 / 1.1;
+                        cannyLow = std::max(1.0, cannyLow * f);
+                        cannyHigh = std::max(cannyLow, cannyHigh * f);
+                        cout << "Edge thresholds: " << cannyLow << ", "
+                             << cannyHigh << "\n";
+                        break;
+                    }
+                }
+            }
+            prevKeyState[i] = cur;
+        }
+
+        // Swap in a requested chain once its background builds are done.
+        shaderCache->poll();
+        applyPendingPasses(false);
+
+        // Update the texture with a new frame from the camera. Iterations
+        // without a fresh frame just redraw the texture already on the GPU.
+        double capture_ms = 0.0, proc_ms = 0.0, trans_ms = 0.0, upload_ms = 0.0;
+        if (freshFrame && !frame.empty() && videoTexture != nullptr) {
+            // Apply CPU filters if requested (modify frame before upload)
+            auto tproc_start = std::chrono::high_resolution_clock::now();
+            switch (currentMode) {
+                case FilterMode::CPU_GRAY:
+                    Filters::applyGrayscaleCPU(frame, framePool);
+                    break;
+                case FilterMode::CPU_EDGE:
+                    Filters::applyCannyCPU(frame, framePool, cannyEngine,
+                                           cannyLow, cannyHigh);
+                    break;
+                case FilterMode::CPU_PIXELATE:
+                    Filters::applyPixelateCPU(frame, framePool, pixelSize);
+                    break;
+                default:
+                    // No CPU processing needed
+                    break;
+            }
+            auto tproc_end = std::chrono::high_resolution_clock::now();
+            proc_ms = std::chrono::duration_cast<
+                          std::chrono::duration<double, std::milli>>(
+                          tproc_end - tproc_start)
+                          .count();
+
+            // Apply CPU transforms if enabled and requested
+            auto ttrans_start = std::chrono::high_resolution_clock::now();
+            if (cpuTransform) {
+                // Same UV transform the GPU shader applies, mapped into
+                // pixel space and applied as a single warp, with the input
+                // as of right now. The cached tables are skipped while the
+                // user drags, since the parameters change every frame then.
+                TransformSnapshot t = latchTransform(inputWindow, true);
+                transformPollMs = t.pollMs;
+                showInput(t);
+                cv::Matx33d uvM = Transforms::composeUVTransform(
+                    t.translateU, t.translateV, t.scale, t.rotation,
+                    (double)frame.cols / (double)frame.rows);
+                remapCache.apply(
+                    frame, framePool,
+                    Transforms::uvToPixelTransform(uvM, frame.size()),
+                    t.dragging);
+            }
+            auto ttrans_end = std::chrono::high_resolution_clock::now();
+            trans_ms = std::chrono::duration_cast<
+                           std::chrono::duration<double, std::milli>>(
+                           ttrans_end - ttrans_start)
+                           .count();
+
+            // Upload the frame to the GPU as is: no flip (the shaders flip V)
+            // and no repack (the row stride goes to GL_UNPACK_ROW_LENGTH).
+            // Gray and edge frames stay 1 channel; the texture switches to
+            // GL_R8 for them on its own.
+            auto tupload_start = std::chrono::high_resolution_clock::now();
+            gpuProfiler->begin("upload");
+            videoTexture->update(frame.data, frame.cols, frame.rows, true,
+                                 frame.channels(), frame.step);
+            gpuProfiler->end("upload");
+            auto tupload_end = std::chrono::high_resolution_clock::now();
+            upload_ms = std::chrono::duration_cast<
+                            std::chrono::duration<double, std::milli>>(
+                            tupload_end - tupload_start)
+                            .count();
+
+            // Only taking the frame from the ring; the blocking read runs
+            // on the capture thread (producer_capture_ms).
+            capture_ms = std::chrono::duration_cast<
+                             std::chrono::duration<double, std::milli>>(
+                             tcap_end - tcap_start)
+                             .count();
+        }
+        // Parity runs compare the GPU Canny with the CPU filter on the
+        // frame just uploaded, which has to happen before its slot is
+        // handed back. (Timings of such runs include this.)
+        cv::Mat cannyReference;
+        if (cannyParity && freshFrame && !frame.empty() &&
+            currentMode == FilterMode::GPU_CANNY) {
+            cannyReference = frame;
+            Filters::applyCannyCPU(cannyReference, framePool, cannyEngine,
+                                   cannyLow, cannyHigh);
+        }
+        // The texture holds its own copy now; give the slot back.
+        if (freshFrame) frameRing.release();
+
+        // Per-frame shader parameters go into the shared uniform buffer
+        // once; whichever program the quad uses reads them from there.
+        auto tdraw_start = std::chrono::high_resolution_clock::now();
+        {
+            // Latch the transform as late as possible: this is the last
+            // point before the frame's first draw call. Input only counts
+            // as shown here when the GPU applies the transform; CPU warped
+            // frames latched theirs before the warp.
+            TransformSnapshot t = latchTransform(inputWindow, gpuTransform);
+            drawPollMs = t.pollMs;
+            showInput(t);
+            // Build the 3x3 UV transform: translate * back * Ainv * R * S
+            // * A * T_neg. The aspect compensation makes rotations in UV
+            // space behave like pixel-space ones.
+            double aspect = 1.0;
+            if (!frame.empty() && frame.rows != 0) {
+                aspect = (double)frame.cols / (double)frame.rows;
+            }
+            cv::Matx33d uvM = Transforms::composeUVTransform(
+                t.translateU, t.translateV, t.scale, t.rotation, aspect);
+            // glm is column-major
+            glm::mat3 M(1.0f);
+            for (int c = 0; c < 3; ++c)
+                for (int r = 0; r < 3; ++r) M[c][r] = (float)uvM(r, c);
+            frameUniforms->setTransform(M);
+            if (!frame.empty()) {
+                frameUniforms->setTexelSize(1.0f / (float)frame.cols,
+                                            1.0f / (float)frame.rows);
+            }
+            // 0.0 outside GPU edge mode keeps the raw gradient magnitude.
+            frameUniforms->setEdgeThreshold(
+                (currentMode == FilterMode::GPU_EDGE ||
+                 currentMode == FilterMode::GPU_EDGE_COMPUTE)
+                    ? 0.2f
+                    : 0.0f);
+            frameUniforms->setPixelSize(pixelSize);
+            frameUniforms->upload();
+            gpuCanny->setThresholds(cannyLow, cannyHigh);
+        }
+        TextureShader* finalPass = passChain.run(videoTexture);
+        if (finalPass != nullptr) myQuad->setShader(finalPass, false);
+        // "draw" is the whole Quad draw, also when no GPU pass runs.
+        gpuProfiler->begin("draw");
+        passChain.beginFinalPass();
+        myScene->render(renderingCamera);
+        passChain.endFinalPass();
+        gpuProfiler->end("draw");
+
+        // Hand consumers the readbacks that have landed, then queue this
+        // frame's result. Neither waits for the GPU.
+        if (readback != nullptr) {
+            readback->collect(readbackIndex);
+            if (freshFrame && passChain.output() != nullptr)
+                readback->capture(*passChain.output(), readbackIndex++);
+        }
+
+        // Headless frames end with the draw calls; nothing is presented.
+        // Unthrottled runs stop the clock before presenting, so frame
+        // times measure the pipeline rather than the swap. Events are
+        // polled at the start of the next frame, not here, so input that
+        // arrives meanwhile still makes it into that frame's transform.
+        auto tdraw_end = std::chrono::high_resolution_clock::now();
+        if (!headless) glfwSwapBuffers(window);
+        if (!unthrottled) tdraw_end = std::chrono::high_resolution_clock::now();
+        bool deadlineMissed = presentPacer.presented();
+        // The swap returning is as close to the photons as we can see.
+        double inputLatencyMs = -1.0;
+        if (frameHasInput) {
+            inputLatencyMs = std::chrono::duration<double, std::milli>(
+                                 std::chrono::steady_clock::now() -
+                                 frameInputTime)
+                                 .count();
+            ++inputSamples;
+            inputLatencySum += inputLatencyMs;
+            inputLatencyMax = std::max(inputLatencyMax, inputLatencyMs);
+        }
+
+        // End timer for this frame
+        auto tend = tdraw_end;
+        double ms =
+            std::chrono::duration_cast<
+                std::chrono::duration<double, std::milli>>(tend - tstart)
+                .count();
+
+        double draw_ms = std::chrono::duration_cast<
+                             std::chrono::duration<double, std::milli>>(
+                             tdraw_end - tdraw_start)
+                             .count();
+        if (unthrottled) {
+            ms -= framePollMs + transformPollMs + drawPollMs;
+            trans_ms -= transformPollMs;
+            draw_ms -= drawPollMs;
+        }
+
+        // Only once the Canny chain is the one actually running.
+        if (!cannyReference.empty() && passChain.passCount() > 0 &&
+            passChain.passName(0) == "canny") {
+            cv::Mat gpuEdges;
+            gpuCanny->readback(gpuEdges);
+            if (gpuEdges.size() == cannyReference.size()) {
+                cv::Mat diff;
+                cv::compare(gpuEdges, cannyReference, diff, cv::CMP_NE);
+                int mismatched = cv::countNonZero(diff);
+                double fraction =
+                    (double)mismatched / (double)cannyReference.total();
+                ++parityFrames;
+                parityMismatched += mismatched;
+                parityPixels += cannyReference.total();
+                parityWorst = std::max(parityWorst, fraction);
+                if (!gpuCanny->converged()) ++parityCapped;
+            }
+        }
+
+        // Only iterations that processed a fresh frame are benchmark samples.
+        if (doBenchmark && freshFrame) {
+            // Create a resolution string
+            int w = (frame.empty() ? 0 : frame.cols);
+            int h = (frame.empty() ? 0 : frame.rows);
+            std::ostringstream resos;
+            resos << w << "x" << h;
+
+            // Write either to CSV file or stdout
+            if (csvOut.is_open()) {
+                csvOut << ms << "," << frameTimesMs.size() << "," << filterArg
+                       << "," << backendArg << "," << resos.str() << ","
+                       << transformsArg << "," << buildType << "\n";
+            } else {
+                std::cout << ms << "," << frameTimesMs.size() << ","
+                          << filterArg << "," << backendArg << ","
+                          << resos.str() << "," << transformsArg << ","
+                          << buildType << std::endl;
+            }
+            if (detailedBenchmark && csvDetailedOut.is_open()) {
+                csvDetailedOut << frameTimesMs.size() << "," << ms << ","
+                               << capture_ms << "," << proc_ms << ","
+                               << trans_ms << "," << upload_ms << "," << draw_ms
+                               << "," << filterArg << "," << backendArg << ","
+                               << resos.str() << "," << transformsArg << ","
+                               << buildType << "," << ringOccupancy << ","
+                               << frameRing.droppedCount() << ","
+                               << frameRing.skippedCount() << ","
+                               << staleIterations << ","
+                               << captureThread.lastCaptureMs() << ","
+                               << captureThread.capturedCount() << ","
+                               << framePool.hits() << ","
+                               << framePool.misses() << ","
+                               << remapCache.hits() << ","
+                               << remapCache.misses() << ","
+                               << remapCache.hitRate() << ","
+                               << passChain.timingSummary() << ","
+                               << (readback ? readback->latencyMs() : -1.0)
+                               << ","
+                               << (readback ? readback->latencyFrames() : 0)
+                               << ","
+                               << (readback ? readback->bandwidthMBs() : -1.0)
+                               << "," << presentPacer.intervalMs() << ","
+                               << (deadlineMissed ? 1 : 0) << ","
+                               << inputLatencyMs;
+                for (const std::string& name : gpuSections)
+                    csvDetailedOut << "," << gpuProfiler->ms(name);
+                csvDetailedOut << "\n";
+            }
+            staleIterations = 0;
+            frameTimesMs.push_back(ms);
+
+            if ((int)frameTimesMs.size() >= benchFrames) {
+                std::cout << "Benchmark complete: captured "
+                          << frameTimesMs.size() << " frames." << std::endl;
+                break;
+            }
+        }
+    }
+
+    // If benchmarking, emit a short summary and close CSV
+    if (doBenchmark) {
+        double sum = 0.0;
+        for (double t : frameTimesMs) sum += t;
+        double mean =
+            frameTimesMs.empty() ? 0.0 : sum / (double)frameTimesMs.size();
+        double var = 0.0;
+        for (double t : frameTimesMs) var += (t - mean) * (t - mean);
+        double stddev = frameTimesMs.size() > 1
+                            ? sqrt(var / (frameTimesMs.size() - 1))
+                            : 0.0;
+        std::cout << "Benchmark summary: frames=" << frameTimesMs.size()
+                  << ", mean_ms=" << mean << ", std_ms=" << stddev
+                  << ", ring_dropped=" << frameRing.droppedCount()
+                  << ", ring_skipped=" << frameRing.skippedCount()
+                  << ", pool_hits=" << framePool.hits()
+                  << ", pool_misses=" << framePool.misses()
+                  << ", pool_mb=" << framePool.bytes() / (1024.0 * 1024.0)
+                  << ", remap_hit_rate=" << remapCache.hitRate()
+                  << "\n";
+        std::string interval = std::to_string(swapInterval);
+        if (swapInterval < 0) interval = "default";
+        if (headless) interval = "none";
+        std::cout << "Presentation: swap_interval=" << interval
+                  << ", unthrottled=" << (unthrottled ? 1 : 0)
+                  << ", target_ms=" << presentPacer.periodMs()
+                  << ", mean_interval_ms=" << presentPacer.meanIntervalMs()
+                  << ", jitter_ms=" << presentPacer.jitterMs()
+                  << ", max_jitter_ms=" << presentPacer.maxJitterMs()
+                  << ", deadline_misses=" << presentPacer.misses() << "\n";
+        if (gpuProfiler->supported()) {
+            std::cout << "GPU profile (latest ms):";
+            for (const std::string& name : gpuSections)
+                std::cout << " " << name << "=" << gpuProfiler->ms(name);
+            std::cout << ", dropped_frames=" << gpuProfiler->dropped()
+                      << "\n";
+        }
+        if (csvOut.is_open()) csvOut.close();
+    }
+
+    if (cannyParity) {
+        std::cout << "Canny parity: frames=" << parityFrames
+                  << ", mismatched_pixels=" << parityMismatched
+                  << ", mismatch_pct="
+                  << (parityPixels > 0
+                          ? 100.0 * (double)parityMismatched / parityPixels
+                          : 0.0)
+                  << ", worst_frame_pct=" << 100.0 * parityWorst
+                  << ", capped_frames=" << parityCapped << "\n";
+    }
+
+    // Interactive runs too: dragging or zooming is what produces samples.
+    if (inputSamples > 0) {
+        std::cout << "Input to present: frames=" << inputSamples
+                  << ", mean_ms=" << inputLatencySum / (double)inputSamples
+                  << ", max_ms=" << inputLatencyMax << "\n";
+    }
+
+    if (readback != nullptr) {
+        // Whatever is still in flight goes to the consumers too.
+        readback->collect(readbackIndex, true);
+        std::cout << "Readback: frames=" << readback->delivered()
+                  << ", latency_ms=" << readback->latencyMs()
+                  << ", latency_frames=" << readback->latencyFrames()
+                  << ", mb_s=" << readback->bandwidthMBs()
+                  << ", stalls=" << readback->stalls() << "\n";
+    }
+
+    // --- Cleanup -----------------------------------------------------------
+    cout << "Closing application..." << endl;
+    captureThread.stop();
+    if (recorder.isOpen()) {
+        cout << "Recorded " << recorder.frameCount() << " frames to "
+             << recordPath << endl;
+        recorder.close();
+    }
+    if (outputRecorder.isOpen()) {
+        cout << "Recorded " << outputRecorder.frameCount()
+             << " processed frames to " << recordOutputPath << endl;
+        outputRecorder.close();
+    }
+    delete source;
+    delete myScene;
+    delete renderingCamera;
+    delete videoTexture;
+    // GL objects have to go before the context does.
+    passChain.clear();
+    renderTargets.release(headlessTarget);
+    renderTargets.clear();
+    delete shaderCache;
+    delete frameUniforms;
+    delete edgeCompute;
+    delete gpuCanny;
+    delete readback;
+    delete gpuProfiler;
+    if (compileContext != nullptr) glfwDestroyWindow(compileContext);
+
+    headlessContext.destroy();
+    glfwTerminate();
+    return 0;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Helper: initWindow (GLFW)                                                 */
+/* ------------------------------------------------------------------------- */
+bool initWindow(std::string windowName, bool visible) {
+    if (!glfwInit()) {
+        fprintf(stderr, "Failed to initialize GLFW\n");
+        return false;
+    }
+    glfwWindowHint(GLFW_SAMPLES, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, visible ? GLFW_TRUE : GLFW_FALSE);
+    window = glfwCreateWindow(1024, 768, windowName.c_str(), NULL, NULL);
+    if (window == NULL) {
+        fprintf(stderr, "Failed to open GLFW window.\n");
+        glfwTerminate();
+        return false;
+    }
+    glfwMakeContextCurrent(window);
+    return true;
+}
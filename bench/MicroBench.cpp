@@ -0,0 +1,252 @@
+#include "bench/MicroBench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "common/FramePool.hpp"
+#include "filters/CannyEngine.hpp"
+#include "filters/Filters.hpp"
+#include "filters/GrayscaleKernel.hpp"
+
+namespace MicroBench {
+
+// Resolutions used by scripts/run_full_bench.sh
+static const cv::Size kSizes[] = {cv::Size(1024, 768), cv::Size(2048, 1536)};
+
+// Median wall time of `fn` in milliseconds after a short warm-up.
+static double medianMs(int iterations, const std::function<void()>& fn) {
+    for (int i = 0; i < 3; ++i) fn();
+    std::vector<double> times;
+    times.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        fn();
+        auto t1 = std::chrono::high_resolution_clock::now();
+        times.push_back(std::chrono::duration_cast<
+                            std::chrono::duration<double, std::milli>>(t1 - t0)
+                            .count());
+    }
+    std::sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+static cv::Mat randomFrame(cv::Size size, int type) {
+    cv::Mat frame(size, type);
+    cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(256));
+    return frame;
+}
+
+/* ------------------------------------------------------------------------- */
+/* grayscale                                                                 */
+/* ------------------------------------------------------------------------- */
+// The original Filters::applyGrayscaleCPU: two cvtColor passes through a
+// temporary allocated on every call.
+static void legacyGrayscale(cv::Mat& frame) {
+    cv::Mat gray;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::cvtColor(gray, frame, cv::COLOR_GRAY2BGR);
+}
+
+static int runGrayscale(int iterations) {
+    printf("grayscale kernel: %s, %d iterations (median ms)\n",
+           Filters::grayscaleKernelName(), iterations);
+    printf("%-10s %12s %12s %12s %12s %9s %9s\n", "resolution",
+           "cvtColor x2", "fused", "luma 1ch", "filter", "speedup",
+           "max_diff");
+
+    int status = 0;
+    for (const cv::Size& size : kSizes) {
+        cv::Mat input = randomFrame(size, CV_8UC3);
+        cv::Mat work = input.clone();
+        FramePool pool;
+
+        double legacyMs = medianMs(iterations, [&]() {
+            input.copyTo(work);
+            legacyGrayscale(work);
+        });
+        double copyMs = medianMs(iterations, [&]() { input.copyTo(work); });
+        double fusedMs = medianMs(iterations, [&]() {
+            Filters::grayscaleBGR(work.data, work.step, work.data, work.step,
+                                  work.cols, work.rows);
+        });
+        cv::Mat luma(size, CV_8UC1);
+        double lumaMs = medianMs(iterations, [&]() {
+            Filters::lumaBGR(input.data, input.step, luma.data, luma.step,
+                             input.cols, input.rows);
+        });
+        // The filter now returns the 1-channel luma frame.
+        double filterMs = medianMs(iterations, [&]() {
+            cv::Mat frame = input;
+            Filters::applyGrayscaleCPU(frame, pool);
+        });
+        // The legacy path runs in place, so take the refill out of its time.
+        legacyMs = std::max(0.0, legacyMs - copyMs);
+
+        // OpenCV uses 14-bit weights, the kernels 8-bit ones. Checks both
+        // the 3-channel kernel and the filter's 1-channel output (lumaBGR).
+        cv::Mat expected = input.clone(), fused = input.clone(), diff;
+        legacyGrayscale(expected);
+        Filters::grayscaleBGR(fused.data, fused.step, fused.data, fused.step,
+                              fused.cols, fused.rows);
+        cv::absdiff(expected, fused, diff);
+        double maxDiff = 0.0, lumaDiff = 0.0;
+        cv::minMaxLoc(diff.reshape(1), nullptr, &maxDiff);
+        cv::Mat expectedLuma, filtered = input;
+        cv::cvtColor(input, expectedLuma, cv::COLOR_BGR2GRAY);
+        Filters::applyGrayscaleCPU(filtered, pool);
+        if (filtered.type() != CV_8UC1) {
+            lumaDiff = 255.0;
+        } else {
+            cv::absdiff(expectedLuma, filtered, diff);
+            cv::minMaxLoc(diff, nullptr, &lumaDiff);
+        }
+        maxDiff = std::max(maxDiff, lumaDiff);
+        if (maxDiff > 1.0) status = 1;
+
+        printf("%4dx%-5d %12.3f %12.3f %12.3f %12.3f %8.2fx %9.0f\n",
+               size.width, size.height, legacyMs, fusedMs, lumaMs, filterMs,
+               filterMs > 0.0 ? legacyMs / filterMs : 0.0, maxDiff);
+    }
+    return status;
+}
+
+/* ------------------------------------------------------------------------- */
+/* pixelate                                                                  */
+/* ------------------------------------------------------------------------- */
+// The original Filters::applyPixelateCPU: cv::mean + setTo per block ROI.
+static void legacyPixelate(const cv::Mat& frame, cv::Mat& out, int pixelSize) {
+    for (int y = 0; y < frame.rows; y += pixelSize) {
+        for (int x = 0; x < frame.cols; x += pixelSize) {
+            cv::Rect roi(x, y, std::min(pixelSize, frame.cols - x),
+                         std::min(pixelSize, frame.rows - y));
+            out(roi).setTo(cv::mean(frame(roi)));
+        }
+    }
+}
+
+static int runPixelate(int iterations) {
+    printf("pixelate, %d iterations (median ms)\n", iterations);
+    printf("%-10s %6s %12s %12s %9s %9s\n", "resolution", "block",
+           "mean+setTo", "block sums", "speedup", "max_diff");
+
+    static const int kBlocks[] = {2, 3, 4, 8, 10, 16};
+    int status = 0;
+    for (const cv::Size& size : kSizes) {
+        cv::Mat input = randomFrame(size, CV_8UC3);
+        cv::Mat expected(size, CV_8UC3);
+        FramePool pool;
+        for (int block : kBlocks) {
+            double legacyMs = medianMs(iterations, [&]() {
+                legacyPixelate(input, expected, block);
+            });
+            cv::Mat frame;
+            double blockMs = medianMs(iterations, [&]() {
+                frame = input;
+                Filters::applyPixelateCPU(frame, pool, block);
+            });
+
+            // cv::mean rounds half to even, the block sums round half up.
+            cv::Mat diff;
+            cv::absdiff(expected, frame, diff);
+            double maxDiff = 0.0;
+            cv::minMaxLoc(diff.reshape(1), nullptr, &maxDiff);
+            if (maxDiff > 1.0) status = 1;
+
+            printf("%4dx%-5d %6d %12.3f %12.3f %8.2fx %9.0f\n", size.width,
+                   size.height, block, legacyMs, blockMs,
+                   blockMs > 0.0 ? legacyMs / blockMs : 0.0, maxDiff);
+        }
+    }
+    return status;
+}
+
+/* ------------------------------------------------------------------------- */
+/* canny                                                                     */
+/* ------------------------------------------------------------------------- */
+// The original Filters::applyCannyCPU: gray, cv::Canny, expand to BGR, with
+// temporaries allocated on every call.
+static void legacyCanny(cv::Mat& frame) {
+    cv::Mat gray, edges;
+    cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    cv::Canny(gray, edges, 50.0, 150.0);
+    cv::cvtColor(edges, frame, cv::COLOR_GRAY2BGR);
+}
+
+// Smooth gradients plus noise, so both strong and weak edges show up.
+static cv::Mat syntheticScene(cv::Size size) {
+    cv::Mat frame = randomFrame(size, CV_8UC3);
+    cv::GaussianBlur(frame, frame, cv::Size(0, 0), 3.0);
+    cv::RNG rng(42);
+    for (int i = 0; i < 40; ++i) {
+        cv::Point c(rng.uniform(0, size.width), rng.uniform(0, size.height));
+        cv::circle(frame, c, rng.uniform(10, size.height / 4),
+                   cv::Scalar(rng.uniform(0, 256), rng.uniform(0, 256),
+                              rng.uniform(0, 256)),
+                   rng.uniform(2, 8));
+    }
+    return frame;
+}
+
+static int runCanny(int iterations) {
+    printf("canny, %d iterations (median ms)\n", iterations);
+    printf("%-10s %12s %12s %12s %12s %9s %10s\n", "resolution", "legacy",
+           "cv::Canny", "engine", "engine+pool", "speedup", "mismatch");
+
+    int status = 0;
+    for (const cv::Size& size : kSizes) {
+        cv::Mat input = syntheticScene(size);
+        cv::Mat work = input.clone();
+        cv::Mat gray, reference, edges;
+        cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
+        Filters::CannyEngine engine;
+        FramePool pool;
+
+        double legacyMs = medianMs(iterations, [&]() {
+            input.copyTo(work);
+            legacyCanny(work);
+        });
+        double copyMs = medianMs(iterations, [&]() { input.copyTo(work); });
+        legacyMs = std::max(0.0, legacyMs - copyMs);
+        double cannyMs = medianMs(iterations, [&]() {
+            cv::Canny(gray, reference, 50.0, 150.0);
+        });
+        double engineMs = medianMs(iterations, [&]() {
+            engine.detect(gray, edges, 50.0, 150.0);
+        });
+        double filterMs = medianMs(iterations, [&]() {
+            cv::Mat frame = input;
+            Filters::applyCannyCPU(frame, pool, engine);
+        });
+
+        // Same operator as cv::Canny (L1 gradient, 3x3 aperture), so the
+        // maps should agree pixel for pixel.
+        cv::Mat diff;
+        cv::compare(reference, edges, diff, cv::CMP_NE);
+        int mismatch = cv::countNonZero(diff);
+        if (mismatch != 0) status = 1;
+
+        printf("%4dx%-5d %12.3f %12.3f %12.3f %12.3f %8.2fx %10d\n",
+               size.width, size.height, legacyMs, cannyMs, engineMs, filterMs,
+               engineMs > 0.0 ? legacyMs / engineMs : 0.0, mismatch);
+    }
+    return status;
+}
+
+int run(const std::string& name, int iterations) {
+    if (iterations <= 0) iterations = 100;
+    if (name == "grayscale") return runGrayscale(iterations);
+    if (name == "pixelate") return runPixelate(iterations);
+    if (name == "canny") return runCanny(iterations);
+    fprintf(stderr,
+            "Unknown microbenchmark '%s' (available: grayscale, pixelate, "
+            "canny)\n",
+            name.c_str());
+    return 1;
+}
+
+}  // namespace MicroBench
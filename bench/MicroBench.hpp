@@ -0,0 +1,20 @@
+/*
+ * MicroBench.hpp
+ *
+ * Stand-alone CPU kernel microbenchmarks (no camera or window needed).
+ * Run with `Webcam --microbench <name> [--iterations N]`.
+ */
+#ifndef MICROBENCH_HPP
+#define MICROBENCH_HPP
+
+#include <string>
+
+namespace MicroBench {
+
+// Run the named benchmark and print a result table to stdout. Returns a
+// process exit code (non-zero for an unknown name or failed check).
+int run(const std::string& name, int iterations);
+
+}  // namespace MicroBench
+
+#endif
@@ -0,0 +1,60 @@
+#include "capture/CaptureThread.hpp"
+
+#include <chrono>
+
+CaptureThread::CaptureThread(FrameSource& source, FrameRing& ring)
+    : m_source(source),
+      m_ring(ring),
+      m_recorder(nullptr),
+      m_running(false),
+      m_finished(false),
+      m_captured(0),
+      m_lastCaptureMs(0.0) {}
+
+CaptureThread::~CaptureThread() { stop(); }
+
+void CaptureThread::start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&CaptureThread::run, this);
+}
+
+void CaptureThread::stop() {
+    m_running.store(false);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void CaptureThread::run() {
+    while (m_running.load(std::memory_order_relaxed)) {
+        // Always drain the device, even when the consumer is behind, so
+        // the driver queue does not fill up with stale frames.
+        cv::Mat* slot = m_ring.beginWrite();
+        cv::Mat& target = slot ? *slot : m_discard;
+
+        auto t0 = std::chrono::high_resolution_clock::now();
+        bool ok = m_source.read(target);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        m_lastCaptureMs.store(
+            std::chrono::duration_cast<
+                std::chrono::duration<double, std::milli>>(t1 - t0)
+                .count());
+
+        if (!ok || target.empty()) {
+            if (m_source.endOfStream()) {
+                m_finished.store(true);
+                return;
+            }
+            // Device hiccup: back off briefly instead of spinning.
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        // Record before publishing: once committed the consumer may modify
+        // the slot in place.
+        if (m_recorder) m_recorder->append(target);
+        if (!slot) {
+            m_ring.markDropped();
+            continue;
+        }
+        m_ring.commitWrite();
+        m_captured.fetch_add(1, std::memory_order_relaxed);
+    }
+}
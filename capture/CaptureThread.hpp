@@ -0,0 +1,69 @@
+/*
+ * CaptureThread.hpp
+ *
+ * Background producer that pulls frames from a FrameSource into a
+ * FrameRing so capture latency no longer stalls the render loop.
+ */
+#ifndef CAPTURETHREAD_HPP
+#define CAPTURETHREAD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameRing.hpp"
+#include "capture/FrameSource.hpp"
+#include "capture/RawFrameFile.hpp"
+
+//!  CaptureThread.
+/*!
+ Owns the producer thread. The frame source must not be touched by any
+ other thread between start() and stop().
+ */
+class CaptureThread {
+public:
+    //! Constructor
+    /*! Does not start capturing, call start(). */
+    CaptureThread(FrameSource& source, FrameRing& ring);
+    //! Destructor
+    /*! Stops and joins the thread if still running. */
+    ~CaptureThread();
+
+    //! start
+    /*! Spawn the producer thread. */
+    void start();
+    //! stop
+    /*! Ask the producer to finish and join it. */
+    void stop();
+    //! setRecorder
+    /*! Append every captured frame to `recorder` (nullptr disables). Call
+        before start(). */
+    void setRecorder(RawFrameWriter* recorder) { m_recorder = recorder; }
+
+    //! capturedCount
+    /*! Frames published into the ring so far. */
+    uint64_t capturedCount() const { return m_captured.load(); }
+    //! lastCaptureMs
+    /*! Duration of the most recent blocking read on the producer thread. */
+    double lastCaptureMs() const { return m_lastCaptureMs.load(); }
+    //! finished
+    /*! True once a replay source ran out of frames and the thread exited. */
+    bool finished() const { return m_finished.load(); }
+
+private:
+    void run();
+
+    FrameSource& m_source;
+    FrameRing& m_ring;
+    RawFrameWriter* m_recorder;
+    std::thread m_thread;
+    std::atomic<bool> m_running;
+    std::atomic<bool> m_finished;
+    std::atomic<uint64_t> m_captured;
+    std::atomic<double> m_lastCaptureMs;
+    cv::Mat m_discard;  //!< target for reads while the ring is full
+};
+
+#endif
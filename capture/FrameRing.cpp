@@ -0,0 +1,70 @@
+#include "capture/FrameRing.hpp"
+
+FrameRing::FrameRing(size_t capacity)
+    : m_slots(capacity < 2 ? 2 : capacity),
+      m_head(0),
+      m_tail(0),
+      m_dropped(0),
+      m_skipped(0),
+      m_acquired(0),
+      m_holding(false) {}
+
+void FrameRing::preallocate(cv::Size size, int type) {
+    for (auto& slot : m_slots) slot.create(size, type);
+}
+
+cv::Mat* FrameRing::beginWrite() {
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    if (head - tail >= m_slots.size()) return nullptr;
+    return &m_slots[head % m_slots.size()];
+}
+
+void FrameRing::commitWrite() {
+    m_head.store(m_head.load(std::memory_order_relaxed) + 1,
+                 std::memory_order_release);
+}
+
+void FrameRing::markDropped() {
+    m_dropped.fetch_add(1, std::memory_order_relaxed);
+}
+
+cv::Mat* FrameRing::acquireLatest() {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t tail = m_tail.load(std::memory_order_relaxed);
+    // A slot still held from the previous call counts as consumed
+    if (m_holding) tail = m_acquired + 1;
+    if (head == tail) {
+        if (m_holding) release();
+        return nullptr;
+    }
+
+    uint64_t newest = head - 1;
+    if (newest > tail)
+        m_skipped.fetch_add(newest - tail, std::memory_order_relaxed);
+    // Free everything older than the newest frame, keep the newest.
+    m_tail.store(newest, std::memory_order_release);
+    m_acquired = newest;
+    m_holding = true;
+    return &m_slots[newest % m_slots.size()];
+}
+
+void FrameRing::release() {
+    if (!m_holding) return;
+    m_tail.store(m_acquired + 1, std::memory_order_release);
+    m_holding = false;
+}
+
+size_t FrameRing::occupancy() const {
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t tail = m_tail.load(std::memory_order_acquire);
+    return (size_t)(head - tail);
+}
+
+uint64_t FrameRing::droppedCount() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+uint64_t FrameRing::skippedCount() const {
+    return m_skipped.load(std::memory_order_relaxed);
+}
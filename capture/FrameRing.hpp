@@ -0,0 +1,78 @@
+/*
+ * FrameRing.hpp
+ *
+ * Fixed-capacity single-producer/single-consumer ring of preallocated
+ * cv::Mat slots. The capture thread writes into free slots, the render loop
+ * borrows the newest ready slot without blocking.
+ */
+#ifndef FRAMERING_HPP
+#define FRAMERING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+//!  FrameRing.
+/*!
+ Lock-free SPSC frame ring. Indices grow monotonically; a slot is
+ index % capacity. The producer owns [head, tail + capacity), the consumer
+ owns [tail, head).
+ */
+class FrameRing {
+public:
+    //! Constructor
+    /*! Creates a ring with the given number of slots (at least 2). */
+    explicit FrameRing(size_t capacity = 3);
+
+    //! preallocate
+    /*! Allocate every slot up front so the producer never reallocates. Must
+        be called before the producer thread is started. */
+    void preallocate(cv::Size size, int type);
+
+    // --- Producer side ---------------------------------------------------
+    //! beginWrite
+    /*! Returns the next free slot, or nullptr when the ring is full. */
+    cv::Mat* beginWrite();
+    //! commitWrite
+    /*! Publish the slot returned by the last beginWrite(). */
+    void commitWrite();
+    //! markDropped
+    /*! Count a frame the producer had to discard because the ring was full. */
+    void markDropped();
+
+    // --- Consumer side ---------------------------------------------------
+    //! acquireLatest
+    /*! Returns the newest ready slot, or nullptr when nothing new has been
+        published. Older ready slots are released and counted as skipped. The
+        slot stays owned by the consumer until release(). */
+    cv::Mat* acquireLatest();
+    //! release
+    /*! Hand the slot from the last acquireLatest() back to the producer. */
+    void release();
+
+    // --- Statistics (safe from either thread) ------------------------------
+    size_t capacity() const { return m_slots.size(); }
+    //! occupancy
+    /*! Number of slots published but not yet released by the consumer. */
+    size_t occupancy() const;
+    //! droppedCount
+    /*! Frames discarded by the producer because the ring was full. */
+    uint64_t droppedCount() const;
+    //! skippedCount
+    /*! Ready frames the consumer skipped to get to the newest one. */
+    uint64_t skippedCount() const;
+
+private:
+    std::vector<cv::Mat> m_slots;
+    std::atomic<uint64_t> m_head;     //!< next index the producer writes
+    std::atomic<uint64_t> m_tail;     //!< oldest index not yet released
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_skipped;
+    uint64_t m_acquired;              //!< index held by the consumer
+    bool m_holding;                   //!< consumer currently holds a slot
+};
+
+#endif
@@ -0,0 +1,206 @@
+#include "capture/FrameSource.hpp"
+#include "capture/RawFrameFile.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <climits>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+/* ------------------------------------------------------------------------- */
+/* FramePacer                                                                */
+/* ------------------------------------------------------------------------- */
+FramePacer::FramePacer(double fps) : m_fps(fps), m_started(false) {}
+
+void FramePacer::wait() {
+    if (m_fps <= 0.0) return;
+    auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(1.0 / m_fps));
+    auto now = std::chrono::steady_clock::now();
+    if (!m_started) {
+        m_started = true;
+        m_next = now + period;
+        return;
+    }
+    if (m_next > now) std::this_thread::sleep_until(m_next);
+    m_next += period;
+    // Fell behind by more than a period: re-anchor rather than burst.
+    if (m_next < now) m_next = now + period;
+}
+
+/* ------------------------------------------------------------------------- */
+/* CameraSource                                                              */
+/* ------------------------------------------------------------------------- */
+CameraSource::CameraSource(int index) : m_index(index), m_capture(index) {}
+
+CameraSource::~CameraSource() { m_capture.release(); }
+
+bool CameraSource::isOpened() const { return m_capture.isOpened(); }
+
+bool CameraSource::read(cv::Mat& frame) {
+    m_capture >> frame;
+    return !frame.empty();
+}
+
+void CameraSource::setResolution(int width, int height) {
+    m_capture.set(cv::CAP_PROP_FRAME_WIDTH, width);
+    m_capture.set(cv::CAP_PROP_FRAME_HEIGHT, height);
+}
+
+std::string CameraSource::describe() const {
+    return "camera " + std::to_string(m_index);
+}
+
+/* ------------------------------------------------------------------------- */
+/* VideoFileSource                                                           */
+/* ------------------------------------------------------------------------- */
+VideoFileSource::VideoFileSource(const std::string& path, bool loop,
+                                 double fps)
+    : m_path(path),
+      m_loop(loop),
+      m_ended(false),
+      m_targetSize(0, 0),
+      m_capture(path) {
+    if (fps < 0.0) {
+        fps = m_capture.isOpened() ? m_capture.get(cv::CAP_PROP_FPS) : 0.0;
+        if (fps <= 0.0) fps = 30.0;
+    }
+    m_pacer = FramePacer(fps);
+}
+
+VideoFileSource::~VideoFileSource() { m_capture.release(); }
+
+bool VideoFileSource::isOpened() const { return m_capture.isOpened(); }
+
+bool VideoFileSource::read(cv::Mat& frame) {
+    if (m_ended) return false;
+    m_pacer.wait();
+
+    bool resize = m_targetSize.width > 0 && m_targetSize.height > 0;
+    cv::Mat& target = resize ? m_decoded : frame;
+    if (!m_capture.read(target) || target.empty()) {
+        if (!m_loop) {
+            m_ended = true;
+            return false;
+        }
+        m_capture.set(cv::CAP_PROP_POS_FRAMES, 0);
+        if (!m_capture.read(target) || target.empty()) {
+            m_ended = true;
+            return false;
+        }
+    }
+    if (resize) cv::resize(m_decoded, frame, m_targetSize, 0, 0,
+                           cv::INTER_AREA);
+    return true;
+}
+
+void VideoFileSource::setResolution(int width, int height) {
+    m_targetSize = cv::Size(width, height);
+}
+
+std::string VideoFileSource::describe() const {
+    return "video " + m_path + (m_loop ? " (loop)" : "") + " @ " +
+           (m_pacer.fps() > 0.0 ? std::to_string(m_pacer.fps()) + " fps"
+                                : std::string("unthrottled"));
+}
+
+/* ------------------------------------------------------------------------- */
+/* ImageSequenceSource                                                       */
+/* ------------------------------------------------------------------------- */
+static bool isImageFile(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) return false;
+    std::string ext = path.substr(dot + 1);
+    for (auto& c : ext) c = (char)tolower(c);
+    return ext == "png" || ext == "jpg" || ext == "jpeg" || ext == "bmp" ||
+           ext == "tif" || ext == "tiff" || ext == "ppm";
+}
+
+ImageSequenceSource::ImageSequenceSource(const std::string& directory,
+                                         bool loop, double fps)
+    : m_directory(directory),
+      m_loop(loop),
+      m_ended(false),
+      m_next(0),
+      m_pacer(fps < 0.0 ? 30.0 : fps) {
+    std::vector<std::string> files;
+    cv::glob(directory + "/*", files, false);
+    std::sort(files.begin(), files.end());
+    for (const auto& f : files) {
+        if (!isImageFile(f)) continue;
+        cv::Mat img = cv::imread(f, cv::IMREAD_COLOR);
+        if (img.empty()) {
+            std::cerr << "Skipping unreadable image '" << f << "'\n";
+            continue;
+        }
+        m_frames.push_back(img);
+    }
+}
+
+bool ImageSequenceSource::isOpened() const { return !m_frames.empty(); }
+
+bool ImageSequenceSource::read(cv::Mat& frame) {
+    if (m_ended || m_frames.empty()) return false;
+    if (m_next >= m_frames.size()) {
+        if (!m_loop) {
+            m_ended = true;
+            return false;
+        }
+        m_next = 0;
+    }
+    m_pacer.wait();
+    // Copy into the caller's buffer (reuses its allocation) so the consumer
+    // may process the frame in place without touching the decoded set.
+    m_frames[m_next++].copyTo(frame);
+    return true;
+}
+
+void ImageSequenceSource::setResolution(int width, int height) {
+    // Resize once up front instead of on every replayed frame.
+    for (auto& img : m_frames) {
+        if (img.cols == width && img.rows == height) continue;
+        cv::Mat resized;
+        cv::resize(img, resized, cv::Size(width, height), 0, 0,
+                   cv::INTER_AREA);
+        img = resized;
+    }
+}
+
+std::string ImageSequenceSource::describe() const {
+    return "images " + m_directory + " (" + std::to_string(m_frames.size()) +
+           " frames" + (m_loop ? ", loop" : "") + ") @ " +
+           (m_pacer.fps() > 0.0 ? std::to_string(m_pacer.fps()) + " fps"
+                                : std::string("unthrottled"));
+}
+
+/* ------------------------------------------------------------------------- */
+/* Factory                                                                   */
+/* ------------------------------------------------------------------------- */
+FrameSource* createFrameSource(const std::string& spec, bool loop,
+                               double fps) {
+    size_t colon = spec.find(':');
+    std::string kind = spec.substr(0, colon);
+    std::string arg = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+    if (kind == "camera") {
+        int index = 1;
+        if (!arg.empty()) {
+            // A malformed index makes the spec unknown rather than throw.
+            char* end = nullptr;
+            long value = std::strtol(arg.c_str(), &end, 10);
+            if (end == arg.c_str() || *end != '\0' || value < 0 ||
+                value > INT_MAX)
+                return nullptr;
+            index = (int)value;
+        }
+        return new CameraSource(index);
+    }
+    if (kind == "video" && !arg.empty())
+        return new VideoFileSource(arg, loop, fps);
+    if (kind == "images" && !arg.empty())
+        return new ImageSequenceSource(arg, loop, fps);
+    if (kind == "raw" && !arg.empty())
+        return new RawReplaySource(arg, loop, fps);
+    return nullptr;
+}
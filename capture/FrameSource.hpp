@@ -0,0 +1,147 @@
+/*
+ * FrameSource.hpp
+ *
+ * Pluggable input for the capture thread: a live camera, a video file or a
+ * directory of images. Replay sources can loop and can either be paced at a
+ * fixed rate or run unthrottled so benchmarks are reproducible without a
+ * camera attached.
+ */
+#ifndef FRAMESOURCE_HPP
+#define FRAMESOURCE_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+//!  FramePacer.
+/*!
+ Sleeps until the next frame deadline. A rate <= 0 disables pacing.
+ */
+class FramePacer {
+public:
+    explicit FramePacer(double fps = 0.0);
+    //! wait
+    /*! Block until the next deadline. Deadlines that were already missed
+        are skipped instead of bursting to catch up. */
+    void wait();
+    double fps() const { return m_fps; }
+
+private:
+    double m_fps;
+    bool m_started;
+    std::chrono::steady_clock::time_point m_next;
+};
+
+//!  FrameSource.
+/*!
+ Abstract frame producer. read() blocks until a frame is available and is
+ only ever called from one thread at a time.
+ */
+class FrameSource {
+public:
+    virtual ~FrameSource() {}
+
+    //! isOpened
+    /*! True if the source could be opened. */
+    virtual bool isOpened() const = 0;
+    //! read
+    /*! Read the next frame into `frame`. Returns false on a failed read or
+        at the end of a non-looping replay. */
+    virtual bool read(cv::Mat& frame) = 0;
+    //! endOfStream
+    /*! True once a replay source has run out of frames. Cameras never end. */
+    virtual bool endOfStream() const { return false; }
+    //! setResolution
+    /*! Cameras request the size from the driver, replay sources resize. */
+    virtual void setResolution(int width, int height) = 0;
+    //! zeroCopy
+    /*! True if read() hands out headers into memory the source owns (e.g.
+        a read-only file mapping). Such frames must be copied before they
+        are modified in place. */
+    virtual bool zeroCopy() const { return false; }
+    //! describe
+    /*! Human readable description for logs. */
+    virtual std::string describe() const = 0;
+};
+
+//!  CameraSource.
+/*!
+ Live capture device opened through cv::VideoCapture.
+ */
+class CameraSource : public FrameSource {
+public:
+    explicit CameraSource(int index);
+    ~CameraSource();
+
+    bool isOpened() const;
+    bool read(cv::Mat& frame);
+    void setResolution(int width, int height);
+    std::string describe() const;
+
+private:
+    int m_index;
+    cv::VideoCapture m_capture;
+};
+
+//!  VideoFileSource.
+/*!
+ Decodes a video file. fps < 0 paces at the file's native rate, fps == 0
+ runs unthrottled, fps > 0 paces at the given rate.
+ */
+class VideoFileSource : public FrameSource {
+public:
+    VideoFileSource(const std::string& path, bool loop, double fps);
+    ~VideoFileSource();
+
+    bool isOpened() const;
+    bool read(cv::Mat& frame);
+    bool endOfStream() const { return m_ended; }
+    void setResolution(int width, int height);
+    std::string describe() const;
+
+private:
+    std::string m_path;
+    bool m_loop;
+    bool m_ended;
+    cv::Size m_targetSize;  //!< (0,0) = native size
+    cv::Mat m_decoded;      //!< decode target when resizing
+    cv::VideoCapture m_capture;
+    FramePacer m_pacer;
+};
+
+//!  ImageSequenceSource.
+/*!
+ Replays every image in a directory in file name order. Images are decoded
+ once at open time so replay measures the pipeline, not the image codec.
+ fps <= 0 runs unthrottled; the default is 30 fps.
+ */
+class ImageSequenceSource : public FrameSource {
+public:
+    ImageSequenceSource(const std::string& directory, bool loop, double fps);
+
+    bool isOpened() const;
+    bool read(cv::Mat& frame);
+    bool endOfStream() const { return m_ended; }
+    void setResolution(int width, int height);
+    std::string describe() const;
+
+private:
+    std::string m_directory;
+    bool m_loop;
+    bool m_ended;
+    size_t m_next;
+    std::vector<cv::Mat> m_frames;
+    FramePacer m_pacer;
+};
+
+//! createFrameSource
+/*! Build a source from a `--source` spec: "camera[:index]",
+    "video:<path>", "images:<directory>" or "raw:<path>". Returns nullptr
+    for an unknown or malformed spec (e.g. a non-numeric camera index).
+    The caller owns the returned object. */
+FrameSource* createFrameSource(const std::string& spec, bool loop,
+                               double fps);
+
+#endif
@@ -0,0 +1,198 @@
+#include "capture/RawFrameFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <iostream>
+
+static const char kRawMagic[8] = {'V', 'C', 'R', 'A', 'W', 'F', 'R', '1'};
+static const uint32_t kRawVersion = 1;
+
+static uint64_t alignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Write the whole buffer at `offset`, retrying short writes.
+static bool writeAt(int fd, const void* data, size_t bytes, uint64_t offset) {
+    const unsigned char* p = (const unsigned char*)data;
+    while (bytes > 0) {
+        ssize_t n = pwrite(fd, p, bytes, (off_t)offset);
+        if (n <= 0) return false;
+        p += n;
+        bytes -= (size_t)n;
+        offset += (uint64_t)n;
+    }
+    return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* RawFrameWriter                                                            */
+/* ------------------------------------------------------------------------- */
+RawFrameWriter::RawFrameWriter() : m_fd(-1), m_nextOffset(0) {
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+RawFrameWriter::~RawFrameWriter() { close(); }
+
+bool RawFrameWriter::open(const std::string& path, cv::Size size, int type) {
+    close();
+    m_fd = ::open(path.c_str(), O_CREAT | O_TRUNC | O_WRONLY, 0644);
+    if (m_fd < 0) {
+        std::cerr << "Could not open '" << path << "' for recording: "
+                  << strerror(errno) << "\n";
+        return false;
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, kRawMagic, sizeof(kRawMagic));
+    m_header.version = kRawVersion;
+    m_header.width = (uint32_t)size.width;
+    m_header.height = (uint32_t)size.height;
+    m_header.type = (uint32_t)type;
+    m_header.stride = (uint32_t)(size.width * CV_ELEM_SIZE(type));
+    m_header.alignment = (uint32_t)(page > 4096 ? page : 4096);
+    m_header.frameBytes = (uint64_t)m_header.stride * m_header.height;
+
+    m_offsets.clear();
+    m_nextOffset = alignUp(sizeof(RawFrameHeader), m_header.alignment);
+    // Placeholder header so a crashed recording is recognisably truncated.
+    return writeAt(m_fd, &m_header, sizeof(m_header), 0);
+}
+
+bool RawFrameWriter::append(const cv::Mat& frame) {
+    if (m_fd < 0) return false;
+    if ((uint32_t)frame.cols != m_header.width ||
+        (uint32_t)frame.rows != m_header.height ||
+        (uint32_t)frame.type() != m_header.type)
+        return false;
+
+    uint64_t offset = m_nextOffset;
+    bool ok = true;
+    if (frame.isContinuous()) {
+        ok = writeAt(m_fd, frame.data, (size_t)m_header.frameBytes, offset);
+    } else {
+        for (int y = 0; y < frame.rows && ok; ++y)
+            ok = writeAt(m_fd, frame.ptr(y), m_header.stride,
+                         offset + (uint64_t)y * m_header.stride);
+    }
+    if (!ok) return false;
+
+    m_offsets.push_back(offset);
+    m_nextOffset = alignUp(offset + m_header.frameBytes, m_header.alignment);
+    return true;
+}
+
+void RawFrameWriter::close() {
+    if (m_fd < 0) return;
+    m_header.frameCount = m_offsets.size();
+    m_header.indexOffset = m_nextOffset;
+    if (!m_offsets.empty())
+        writeAt(m_fd, m_offsets.data(), m_offsets.size() * sizeof(uint64_t),
+                m_header.indexOffset);
+    writeAt(m_fd, &m_header, sizeof(m_header), 0);
+    ::close(m_fd);
+    m_fd = -1;
+}
+
+/* ------------------------------------------------------------------------- */
+/* RawReplaySource                                                           */
+/* ------------------------------------------------------------------------- */
+RawReplaySource::RawReplaySource(const std::string& path, bool loop,
+                                 double fps)
+    : m_path(path),
+      m_loop(loop),
+      m_ended(false),
+      m_next(0),
+      m_base(nullptr),
+      m_mappedBytes(0),
+      m_offsets(nullptr),
+      m_pacer(fps < 0.0 ? 30.0 : fps) {
+    memset(&m_header, 0, sizeof(m_header));
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open raw recording '" << path
+                  << "': " << strerror(errno) << "\n";
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(RawFrameHeader)) {
+        ::close(fd);
+        std::cerr << "'" << path << "' is not a raw recording\n";
+        return;
+    }
+    size_t fileBytes = (size_t)st.st_size;
+    void* base = mmap(nullptr, fileBytes, PROT_READ, MAP_SHARED, fd, 0);
+    // The mapping keeps the file referenced; the descriptor is not needed.
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "mmap of '" << path << "' failed: " << strerror(errno)
+                  << "\n";
+        return;
+    }
+
+    memcpy(&m_header, base, sizeof(m_header));
+    bool valid = memcmp(m_header.magic, kRawMagic, sizeof(kRawMagic)) == 0 &&
+                 m_header.version == kRawVersion && m_header.frameCount > 0 &&
+                 m_header.indexOffset +
+                         m_header.frameCount * sizeof(uint64_t) <=
+                     fileBytes;
+    const uint64_t* offsets =
+        valid ? (const uint64_t*)((unsigned char*)base + m_header.indexOffset)
+              : nullptr;
+    for (uint64_t i = 0; valid && i < m_header.frameCount; ++i)
+        valid = offsets[i] + m_header.frameBytes <= fileBytes;
+    if (!valid) {
+        munmap(base, fileBytes);
+        std::cerr << "'" << path << "' is not a valid raw recording\n";
+        return;
+    }
+
+    // Replay walks the file front to back; let the kernel read ahead.
+    madvise(base, fileBytes, MADV_SEQUENTIAL);
+    m_base = (unsigned char*)base;
+    m_mappedBytes = fileBytes;
+    m_offsets = offsets;
+}
+
+RawReplaySource::~RawReplaySource() {
+    if (m_base) munmap(m_base, m_mappedBytes);
+}
+
+bool RawReplaySource::read(cv::Mat& frame) {
+    if (m_ended || m_base == nullptr) return false;
+    if (m_next >= m_header.frameCount) {
+        if (!m_loop) {
+            m_ended = true;
+            return false;
+        }
+        m_next = 0;
+    }
+    m_pacer.wait();
+    // Header only: the pixels stay in the page cache behind the mapping.
+    frame = cv::Mat((int)m_header.height, (int)m_header.width,
+                    (int)m_header.type, m_base + m_offsets[m_next++],
+                    m_header.stride);
+    return true;
+}
+
+void RawReplaySource::setResolution(int width, int height) {
+    if ((uint32_t)width == m_header.width &&
+        (uint32_t)height == m_header.height)
+        return;
+    std::cerr << "Raw replay cannot be resized; playing at recorded "
+              << m_header.width << "x" << m_header.height << "\n";
+}
+
+std::string RawReplaySource::describe() const {
+    return "raw " + m_path + " (" + std::to_string(m_header.frameCount) +
+           " frames, " + std::to_string(m_header.width) + "x" +
+           std::to_string(m_header.height) + (m_loop ? ", loop" : "") +
+           ") @ " +
+           (m_pacer.fps() > 0.0 ? std::to_string(m_pacer.fps()) + " fps"
+                                : std::string("unthrottled"));
+}
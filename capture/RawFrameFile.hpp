@@ -0,0 +1,102 @@
+/*
+ * RawFrameFile.hpp
+ *
+ * Indexed raw frame container used by --record and the raw:<path> replay
+ * source. Layout:
+ *
+ *   [RawFrameHeader][pad][frame 0][pad][frame 1]...[pad][uint64 offsets[N]]
+ *
+ * Every payload starts on a page boundary and holds tightly packed rows, so
+ * a replay can mmap the file and wrap cv::Mat headers directly around the
+ * mapping: no decode and no copy.
+ */
+#ifndef RAWFRAMEFILE_HPP
+#define RAWFRAMEFILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "capture/FrameSource.hpp"
+
+//! On-disk header, written at offset 0 (native endianness).
+struct RawFrameHeader {
+    char magic[8];         //!< "VCRAWFR1"
+    uint32_t version;      //!< format version, currently 1
+    uint32_t width;        //!< frame width in pixels
+    uint32_t height;       //!< frame height in pixels
+    uint32_t type;         //!< OpenCV type, e.g. CV_8UC3
+    uint32_t stride;       //!< bytes per row
+    uint32_t alignment;    //!< payload alignment in bytes (>= page size)
+    uint64_t frameBytes;   //!< stride * height
+    uint64_t frameCount;   //!< number of entries in the offset table
+    uint64_t indexOffset;  //!< file offset of the uint64 offset table
+};
+
+//!  RawFrameWriter.
+/*!
+ Appends fixed-size frames to a raw container. The header and offset table
+ are finalised by close().
+ */
+class RawFrameWriter {
+public:
+    RawFrameWriter();
+    ~RawFrameWriter();
+
+    //! open
+    /*! Create/truncate `path` for frames of the given size and type. */
+    bool open(const std::string& path, cv::Size size, int type);
+    //! append
+    /*! Write one frame. Frames with a different size or type are rejected. */
+    bool append(const cv::Mat& frame);
+    //! close
+    /*! Write the offset table and the final header. */
+    void close();
+
+    bool isOpen() const { return m_fd >= 0; }
+    uint64_t frameCount() const { return m_offsets.size(); }
+
+private:
+    int m_fd;
+    RawFrameHeader m_header;
+    uint64_t m_nextOffset;           //!< aligned offset of the next payload
+    std::vector<uint64_t> m_offsets;
+};
+
+//!  RawReplaySource.
+/*!
+ Zero-copy replay of a raw container. Frames are cv::Mat headers pointing
+ into a read-only mapping of the file, so consumers must not write into
+ them (see zeroCopy()). fps <= 0 runs unthrottled; the default is 30 fps.
+ */
+class RawReplaySource : public FrameSource {
+public:
+    RawReplaySource(const std::string& path, bool loop, double fps);
+    ~RawReplaySource();
+
+    bool isOpened() const { return m_base != nullptr; }
+    bool read(cv::Mat& frame);
+    bool endOfStream() const { return m_ended; }
+    //! setResolution
+    /*! Not supported: resizing would defeat zero-copy. Record at the wanted
+        resolution instead. */
+    void setResolution(int width, int height);
+    bool zeroCopy() const { return true; }
+    std::string describe() const;
+
+private:
+    std::string m_path;
+    bool m_loop;
+    bool m_ended;
+    uint64_t m_next;
+    unsigned char* m_base;   //!< start of the mapping
+    size_t m_mappedBytes;
+    RawFrameHeader m_header;
+    const uint64_t* m_offsets;
+    FramePacer m_pacer;
+};
+
+#endif
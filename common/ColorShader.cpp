@@ -1,7 +1,7 @@
 
 #include "ColorShader.hpp"
 
-ColorShader::ColorShader(){
+ColorShader::ColorShader() : colorID(-1){
     
 }
 // version of constructor that allows for  vertex and fragment shader with different names
@@ -9,7 +9,7 @@ ColorShader::ColorShader(){
 ColorShader::ColorShader(std::string vertexshaderName, std::string fragmentshaderName): Shader(vertexshaderName, fragmentshaderName){
     
     // add color parameter to shader
-    GLint colorID = glGetUniformLocation(programID, "colorValue");
+    colorID = uniformLocation("colorValue");
     color = glm::vec4(1.0,1.0,1.0,1.0);
     glUniform4f(colorID, color[0],color[1],color[2],color[3]);
     
@@ -19,7 +19,7 @@ ColorShader::ColorShader(std::string vertexshaderName, std::string fragmentshade
 ColorShader::ColorShader(std::string shaderName): Shader(shaderName){
     
     // add color parameter to shader
-    GLint colorID = glGetUniformLocation(programID, "colorValue");
+    colorID = uniformLocation("colorValue");
     color = glm::vec4(1.0,1.0,1.0,1.0);
     glProgramUniform4fv(programID,colorID,1, &color[0]);
     
@@ -29,6 +29,5 @@ ColorShader::ColorShader(std::string shaderName): Shader(shaderName){
 void ColorShader::setColor(glm::vec4 newcolor){
     color = newcolor;
     // Send our colour value to the currently bound shader,
-    GLint colorID = glGetUniformLocation(programID, "colorValue");
     glProgramUniform4fv(programID,colorID,1, &color[0]);
 }
@@ -0,0 +1,71 @@
+#include "ComputeShader.hpp"
+
+#include <stdio.h>
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+ComputeShader::ComputeShader(const std::string& path) {
+    programID = 0;
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        printf("ComputeShader: cannot read %s\n", path.c_str());
+        return;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    const std::string source = ss.str();
+
+    printf("Compiling compute shader : %s\n", path.c_str());
+    GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+    const char* src = source.c_str();
+    glShaderSource(shader, 1, &src, NULL);
+    glCompileShader(shader);
+    GLint ok = GL_FALSE, logLength = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(logLength + 1, '\0');
+        if (logLength > 0)
+            glGetShaderInfoLog(shader, logLength, NULL, log.data());
+        printf("%s: %s\n", path.c_str(), log.data());
+        glDeleteShader(shader);
+        return;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, shader);
+    glLinkProgram(program);
+    glDetachShader(program, shader);
+    glDeleteShader(shader);
+    glGetProgramiv(program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(logLength + 1, '\0');
+        if (logLength > 0)
+            glGetProgramInfoLog(program, logLength, NULL, log.data());
+        printf("Linking %s failed: %s\n", path.c_str(), log.data());
+        glDeleteProgram(program);
+        return;
+    }
+    adoptProgram(program, true);
+    glGetProgramiv(programID, GL_COMPUTE_WORK_GROUP_SIZE, m_groupSize);
+}
+
+// The shaders are GLSL 4.30 (explicit bindings, image formats), which a
+// 3.x context with only the ARB extensions would not compile.
+bool ComputeShader::supported() { return GLAD_GL_VERSION_4_3 != 0; }
+
+void ComputeShader::dispatch(Texture* input, Texture* output,
+                             GLenum format) {
+    const int width = input->getWidth(), height = input->getHeight();
+    bind();
+    input->bindTexture();
+    glBindImageTexture(0, output->getTextureID(), 0, GL_FALSE, 0,
+                       GL_WRITE_ONLY, format);
+    glDispatchCompute((width + m_groupSize[0] - 1) / m_groupSize[0],
+                      (height + m_groupSize[1] - 1) / m_groupSize[1], 1);
+    // The next pass samples the image.
+    glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+}
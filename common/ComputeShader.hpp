@@ -0,0 +1,46 @@
+/*
+ * ComputeShader.hpp
+ *
+ * A single-stage compute program (OpenGL 4.3, GLSL 4.30) that
+ * reads one texture and writes one image, for GPU filters that share work
+ * between neighbouring pixels through shared memory. Runs as a pass of a
+ * PassChain; the Quad then samples the image it wrote.
+ */
+#ifndef COMPUTESHADER_HPP
+#define COMPUTESHADER_HPP
+
+#include <string>
+
+#include "Shader.hpp"
+#include "Texture.hpp"
+
+//!  ComputeShader.
+/*!
+ The input is bound as a sampler on texture unit 0 (texture1), the output
+ as image unit 0. Uniform locations and the FrameParams block are set up
+ like for every other Shader.
+ */
+class ComputeShader : public Shader {
+public:
+    //! Constructor
+    /*! Compile and link the compute shader at `path`. Check valid(). */
+    explicit ComputeShader(const std::string& path);
+
+    //! supported
+    /*! True if the current context is OpenGL 4.3 or later. */
+    static bool supported();
+    //! valid
+    /*! False if the shader failed to compile or link. */
+    bool valid() const { return programID != 0; }
+
+    //! dispatch
+    /*! Run one invocation per pixel of `input`, writing `output` (same
+        size, storage `format`). Results are visible to later texture
+        fetches once this returns. */
+    void dispatch(Texture* input, Texture* output, GLenum format);
+
+private:
+    GLint m_groupSize[3] = {1, 1, 1};  // local_size_x/y/z of the shader
+};
+
+#endif
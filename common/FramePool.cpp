@@ -0,0 +1,34 @@
+#include "common/FramePool.hpp"
+
+#include <cstring>
+
+bool FramePool::Key::operator<(const Key& other) const {
+    int c = strcmp(tag, other.tag);
+    if (c != 0) return c < 0;
+    if (width != other.width) return width < other.width;
+    if (height != other.height) return height < other.height;
+    return type < other.type;
+}
+
+FramePool::FramePool() : m_hits(0), m_misses(0), m_bytes(0) {}
+
+cv::Mat& FramePool::acquire(const char* tag, cv::Size size, int type) {
+    Key key = {tag, size.width, size.height, type};
+    auto it = m_buffers.find(key);
+    if (it != m_buffers.end()) {
+        ++m_hits;
+        return it->second;
+    }
+    ++m_misses;
+    cv::Mat& buffer = m_buffers[key];
+    buffer.create(size, type);
+    m_bytes += buffer.total() * buffer.elemSize();
+    return buffer;
+}
+
+void FramePool::clear() {
+    m_buffers.clear();
+    m_hits = 0;
+    m_misses = 0;
+    m_bytes = 0;
+}
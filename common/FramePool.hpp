@@ -0,0 +1,62 @@
+/*
+ * FramePool.hpp
+ *
+ * Resolution-keyed pool of reusable cv::Mat scratch buffers for the CPU
+ * filters and transforms. Each stage asks for its buffers by tag; the pool
+ * only allocates when a (tag, size, type) combination is seen for the first
+ * time, so the steady state does no heap allocation after the first frame.
+ */
+#ifndef FRAMEPOOL_HPP
+#define FRAMEPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+
+#include <opencv2/opencv.hpp>
+
+//!  FramePool.
+/*!
+ Not thread-safe: acquire buffers on the render thread, then hand them to
+ parallel workers if needed.
+ */
+class FramePool {
+public:
+    FramePool();
+
+    //! acquire
+    /*! Return the buffer for `tag` with the given size and type. The
+        reference stays valid for the lifetime of the pool and its contents
+        are left over from the previous use. `tag` must be a string literal
+        (or otherwise outlive the pool). */
+    cv::Mat& acquire(const char* tag, cv::Size size, int type);
+
+    //! hits
+    /*! Requests served by an existing buffer. */
+    uint64_t hits() const { return m_hits; }
+    //! misses
+    /*! Requests that had to allocate. */
+    uint64_t misses() const { return m_misses; }
+    //! bytes
+    /*! Total bytes held by the pool. */
+    size_t bytes() const { return m_bytes; }
+    //! clear
+    /*! Drop every buffer and reset the statistics. */
+    void clear();
+
+private:
+    struct Key {
+        const char* tag;
+        int width;
+        int height;
+        int type;
+        bool operator<(const Key& other) const;
+    };
+
+    std::map<Key, cv::Mat> m_buffers;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    size_t m_bytes;
+};
+
+#endif
@@ -0,0 +1,139 @@
+#include "FrameReadback.hpp"
+
+FrameReadback::FrameReadback(int slots)
+    : m_slots(slots < 1 ? 1 : slots),
+      m_next(0),
+      m_pending(0),
+      m_delivered(0),
+      m_stalls(0),
+      m_latencyMs(-1.0),
+      m_latencyFrames(0),
+      m_bandwidthMBs(-1.0) {
+    for (Slot& s : m_slots) {
+        glGenBuffers(1, &s.pbo);
+        glGenQueries(1, &s.query);
+    }
+}
+
+FrameReadback::~FrameReadback() {
+    for (Slot& s : m_slots) {
+        if (s.fence) glDeleteSync(s.fence);
+        glDeleteBuffers(1, &s.pbo);
+        glDeleteQueries(1, &s.query);
+    }
+}
+
+void FrameReadback::addConsumer(const Consumer& consumer) {
+    m_consumers.push_back(consumer);
+}
+
+void FrameReadback::capture(const RenderTarget& target, int64_t index) {
+    const int count = (int)m_slots.size();
+    if (m_pending == count) {
+        // Ring full: the oldest readback has to be delivered before its
+        // buffer can be reused.
+        ++m_stalls;
+        collect(index, false);
+        if (m_pending == count) {
+            Slot& oldest = m_slots[m_next];
+            if (!deliver(oldest, index, true)) {
+                // Timed out or the wait failed: drain the GPU so nothing
+                // writes the buffer any more, and drop the frame if its
+                // fence still cannot be used.
+                glFinish();
+                if (!deliver(oldest, index, false)) {
+                    glDeleteSync(oldest.fence);
+                    oldest.fence = nullptr;
+                }
+            }
+            --m_pending;
+        }
+    }
+
+    Slot& s = m_slots[m_next];
+    s.width = target.width;
+    s.height = target.height;
+    // Single-channel targets (gray, edge and Canny passes) are read as
+    // GL_RED: glReadPixels ignores the texture swizzle, so GL_BGR would
+    // come back red-only. deliver() expands them to BGR.
+    s.channels = target.format == GL_R8 ? 1 : 3;
+    // GL_PACK_ALIGNMENT 4 pads rows to whole words.
+    s.step = ((size_t)target.width * s.channels + 3) & ~(size_t)3;
+    const size_t bytes = s.step * target.height;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, s.pbo);
+    if (bytes > s.capacity) {
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        s.capacity = bytes;
+    }
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, target.framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBeginQuery(GL_TIME_ELAPSED, s.query);
+    // With a pack buffer bound the last argument is an offset into it and
+    // the call returns without waiting for the copy.
+    glReadPixels(0, 0, target.width, target.height,
+                 s.channels == 1 ? GL_RED : GL_BGR, GL_UNSIGNED_BYTE,
+                 (void*)0);
+    glEndQuery(GL_TIME_ELAPSED);
+    s.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    s.index = index;
+    s.issued = Clock::now();
+
+    m_next = (m_next + 1) % count;
+    ++m_pending;
+}
+
+int FrameReadback::collect(int64_t current, bool wait) {
+    const int count = (int)m_slots.size();
+    int n = 0;
+    while (m_pending > 0) {
+        Slot& oldest = m_slots[(m_next - m_pending + count) % count];
+        if (!deliver(oldest, current, wait)) break;
+        --m_pending;
+        ++n;
+    }
+    return n;
+}
+
+// Map and hand out one slot if its fence has signalled (or, with `wait`,
+// once it has). Returns false if it is still in flight.
+bool FrameReadback::deliver(Slot& slot, int64_t current, bool wait) {
+    GLenum status =
+        glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+                         wait ? 1000000000ull : 0);
+    if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+        return false;
+    glDeleteSync(slot.fence);
+    slot.fence = nullptr;
+
+    const size_t bytes = slot.step * slot.height;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, slot.pbo);
+    void* data =
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (data) {
+        cv::Mat frame(slot.height, slot.width, CV_8UC(slot.channels), data,
+                      slot.step);
+        if (slot.channels == 1) {
+            cv::cvtColor(frame, m_expanded, cv::COLOR_GRAY2BGR);
+            frame = m_expanded;
+        }
+        for (const Consumer& consumer : m_consumers)
+            consumer(frame, slot.index);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    // The query ended before the fence, so its result is in.
+    GLuint64 ns = 0;
+    glGetQueryObjectui64v(slot.query, GL_QUERY_RESULT, &ns);
+    m_bandwidthMBs = ns > 0 ? (double)bytes / ((double)ns / 1.0e9) / 1.0e6
+                            : -1.0;
+    m_latencyMs = std::chrono::duration_cast<
+                      std::chrono::duration<double, std::milli>>(
+                      Clock::now() - slot.issued)
+                      .count();
+    m_latencyFrames = current - slot.index;
+    ++m_delivered;
+    return true;
+}
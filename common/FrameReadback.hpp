@@ -0,0 +1,111 @@
+/*
+ * FrameReadback.hpp
+ *
+ * Asynchronous readback of processed frames for CPU consumers (recorder,
+ * streamer, analytics). capture() only queues a glReadPixels from a render
+ * target into one of a ring of pixel-pack buffers and drops a fence behind
+ * it; collect() hands every readback whose fence has signalled to the
+ * consumers, typically one or two frames later, so the render loop never
+ * waits for the GPU to catch up. Counterpart of the upload ring in
+ * Texture::update().
+ */
+#ifndef FRAMEREADBACK_HPP
+#define FRAMEREADBACK_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "RenderTargetPool.hpp"
+
+//!  FrameReadback.
+/*!
+ Frames come back as CV_8UC3 BGR in the source's top-down row order (the
+ order PassChain targets keep); GL_R8 targets are read as one channel and
+ expanded on delivery. Needs a current GL context for its whole
+ lifetime.
+ */
+class FrameReadback {
+public:
+    //! Consumer
+    /*! Gets each frame with the index passed to capture(). The Mat points
+        into the mapped buffer and is only valid during the call: clone it
+        to keep it. */
+    typedef std::function<void(const cv::Mat& frame, int64_t index)>
+        Consumer;
+
+    //! Constructor
+    /*! `slots` readbacks can be in flight at once. */
+    explicit FrameReadback(int slots = 3);
+    //! Destructor
+    /*! Deletes the buffers, fences and queries without delivering what is
+        still in flight (call collect(..., true) first for that). */
+    ~FrameReadback();
+
+    //! addConsumer
+    void addConsumer(const Consumer& consumer);
+
+    //! capture
+    /*! Queue a readback of `target` for frame `index`. If every slot is
+        still in flight (the GPU is more than `slots` frames behind), waits
+        for the oldest one and delivers it first; if that wait times out,
+        finishes the GPU work and drops the frame if it still cannot be
+        delivered. */
+    void capture(const RenderTarget& target, int64_t index);
+    //! collect
+    /*! Deliver finished readbacks, oldest first. `current` is the index of
+        the frame being rendered, for the latency in frames. With `wait`
+        everything in flight is delivered. Returns the number delivered. */
+    int collect(int64_t current, bool wait = false);
+
+    //! delivered
+    /*! Frames handed to the consumers so far. */
+    int64_t delivered() const { return m_delivered; }
+    //! stalls
+    /*! capture() calls that had to wait for a slot. */
+    int64_t stalls() const { return m_stalls; }
+    //! latencyMs
+    /*! Time from capture() to delivery of the latest frame; -1 before the
+        first one. */
+    double latencyMs() const { return m_latencyMs; }
+    //! latencyFrames
+    /*! Frames between capture() and delivery of the latest frame. */
+    int64_t latencyFrames() const { return m_latencyFrames; }
+    //! bandwidthMBs
+    /*! Bytes per second of GPU time the latest readback's copy took (from
+        a GL_TIME_ELAPSED query around it), in MB/s; -1 if unknown. */
+    double bandwidthMBs() const { return m_bandwidthMBs; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Slot {
+        GLuint pbo = 0;
+        GLuint query = 0;
+        GLsync fence = nullptr;  // null when the slot is free
+        size_t capacity = 0;     // bytes allocated for the buffer
+        int width = 0, height = 0;
+        int channels = 3;  // 1 for GL_R8 targets
+        size_t step = 0;
+        int64_t index = 0;
+        Clock::time_point issued;
+    };
+
+    bool deliver(Slot& slot, int64_t current, bool wait);
+
+    std::vector<Slot> m_slots;
+    std::vector<Consumer> m_consumers;
+    cv::Mat m_expanded;  // BGR copy of the latest single-channel frame
+    int m_next;     // slot the next capture() uses
+    int m_pending;  // slots in flight, the oldest being m_next - m_pending
+    int64_t m_delivered;
+    int64_t m_stalls;
+    double m_latencyMs;
+    int64_t m_latencyFrames;
+    double m_bandwidthMBs;
+};
+
+#endif
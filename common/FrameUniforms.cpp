@@ -0,0 +1,51 @@
+#include "FrameUniforms.hpp"
+
+#include <string.h>
+
+FrameUniforms::FrameUniforms() {
+    memset(&m_block, 0, sizeof(m_block));
+    setTransform(glm::mat3(1.0f));
+    m_block.pixelSize = 1;
+    m_uploaded = m_block;
+
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), &m_block, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, Shader::kFrameBlockBinding, m_buffer);
+}
+
+FrameUniforms::~FrameUniforms() {
+    if (m_buffer) glDeleteBuffers(1, &m_buffer);
+}
+
+void FrameUniforms::setTransform(const glm::mat3& transform) {
+    for (int c = 0; c < 3; ++c)
+        for (int r = 0; r < 3; ++r)
+            m_block.transform[c * 4 + r] = transform[c][r];
+}
+
+void FrameUniforms::setTexelSize(float du, float dv) {
+    m_block.texelOffset[0] = du;
+    m_block.texelOffset[1] = dv;
+}
+
+void FrameUniforms::setEdgeThreshold(float threshold) {
+    m_block.edgeThreshold = threshold;
+}
+
+void FrameUniforms::setPixelSize(int pixelSize) {
+    m_block.pixelSize = pixelSize;
+}
+
+void FrameUniforms::upload() {
+    if (memcmp(&m_block, &m_uploaded, sizeof(Block)) == 0) return;
+    // Orphan first so a frame still reading the old values never stalls
+    // the write.
+    glBindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(Block), NULL, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Block), &m_block);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    m_uploaded = m_block;
+    ++m_uploads;
+}
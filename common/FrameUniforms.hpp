@@ -0,0 +1,76 @@
+/*
+ * FrameUniforms.hpp
+ *
+ * Per-frame shader parameters (UV transform, texel size, edge threshold,
+ * pixelate block size)
+ * kept in one std140 uniform buffer on Shader::kFrameBlockBinding. Every
+ * program declaring the FrameParams block reads from it, so the render
+ * loop writes the values once per frame instead of looking up and setting
+ * uniforms on whichever program happens to be bound.
+ */
+#ifndef FRAMEUNIFORMS_HPP
+#define FRAMEUNIFORMS_HPP
+
+#include <cstdint>
+
+#include "Shader.hpp"
+
+//!  FrameUniforms.
+/*!
+ Mirrors this GLSL block (std140):
+
+     layout(std140) uniform FrameParams {
+         mat3 uTransform;
+         vec2 texelOffset;
+         float edgeThreshold;
+         int pixelSize;
+     };
+
+ Needs a current GL context for its whole lifetime.
+ */
+class FrameUniforms {
+public:
+    //! Constructor
+    /*! Creates the buffer and binds it to Shader::kFrameBlockBinding. */
+    FrameUniforms();
+    //! Destructor
+    ~FrameUniforms();
+
+    //! setTransform
+    /*! UV transform applied by the transform shader. */
+    void setTransform(const glm::mat3& transform);
+    //! setTexelSize
+    /*! One texel in UV units, (1 / width, 1 / height). */
+    void setTexelSize(float du, float dv);
+    //! setEdgeThreshold
+    /*! Threshold of the GPU edge shader; <= 0 shows raw gradients. */
+    void setEdgeThreshold(float threshold);
+    //! setPixelSize
+    /*! Pixelate block size in pixels. */
+    void setPixelSize(int pixelSize);
+
+    //! upload
+    /*! Write the values set since the last call into the buffer. Skipped
+        when nothing changed (the constructor uploads the defaults). */
+    void upload();
+
+    //! uploads
+    /*! Buffer writes so far (unchanged frames do not count). */
+    int uploads() const { return m_uploads; }
+
+private:
+    // std140: each mat3 column is padded to a vec4.
+    struct Block {
+        float transform[12];
+        float texelOffset[2];
+        float edgeThreshold;
+        int32_t pixelSize;
+    };
+
+    GLuint m_buffer = 0;
+    Block m_block;
+    Block m_uploaded;
+    int m_uploads = 0;
+};
+
+#endif
@@ -0,0 +1,89 @@
+#include "GPUProfiler.hpp"
+
+GPUProfiler::GPUProfiler(int frames)
+    : m_frames(frames < 1 ? 1 : frames),
+      m_current(0),
+      m_supported(false),
+      m_dropped(0) {
+    GLint bits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+    m_supported = bits > 0;
+}
+
+GPUProfiler::~GPUProfiler() {
+    for (Frame& f : m_frames)
+        if (!f.queries.empty())
+            glDeleteQueries((GLsizei)f.queries.size(), f.queries.data());
+}
+
+GLuint GPUProfiler::query(Frame& frame) {
+    if (frame.used == frame.queries.size()) {
+        GLuint q = 0;
+        glGenQueries(1, &q);
+        frame.queries.push_back(q);
+    }
+    return frame.queries[frame.used++];
+}
+
+// Sum each name's sections, but only if every query of the frame has
+// landed; the last one written is checked, the GPU completes them in
+// order.
+void GPUProfiler::collect(Frame& frame) {
+    if (frame.sections.empty()) return;
+    GLint available = 0;
+    glGetQueryObjectiv(frame.queries[frame.used - 1],
+                       GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        ++m_dropped;
+        return;
+    }
+    std::map<std::string, double> sums;
+    for (const Section& s : frame.sections) {
+        if (s.open) continue;
+        GLuint64 t0 = 0, t1 = 0;
+        glGetQueryObjectui64v(s.start, GL_QUERY_RESULT, &t0);
+        glGetQueryObjectui64v(s.end, GL_QUERY_RESULT, &t1);
+        sums[s.name] += (double)(t1 - t0) / 1.0e6;
+    }
+    for (const auto& entry : sums) m_ms[entry.first] = entry.second;
+}
+
+void GPUProfiler::beginFrame() {
+    if (!m_supported) return;
+    m_current = (m_current + 1) % (int)m_frames.size();
+    Frame& frame = m_frames[m_current];
+    collect(frame);
+    frame.sections.clear();
+    frame.used = 0;
+}
+
+void GPUProfiler::begin(const std::string& name) {
+    if (!m_supported) return;
+    Frame& frame = m_frames[m_current];
+    Section s;
+    s.name = name;
+    s.start = query(frame);
+    s.end = 0;
+    s.open = true;
+    glQueryCounter(s.start, GL_TIMESTAMP);
+    frame.sections.push_back(s);
+}
+
+void GPUProfiler::end(const std::string& name) {
+    if (!m_supported) return;
+    Frame& frame = m_frames[m_current];
+    for (size_t i = frame.sections.size(); i-- > 0;) {
+        Section& s = frame.sections[i];
+        if (s.open && s.name == name) {
+            s.end = query(frame);
+            s.open = false;
+            glQueryCounter(s.end, GL_TIMESTAMP);
+            return;
+        }
+    }
+}
+
+double GPUProfiler::ms(const std::string& name) const {
+    auto it = m_ms.find(name);
+    return it == m_ms.end() ? -1.0 : it->second;
+}
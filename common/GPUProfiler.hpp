@@ -0,0 +1,83 @@
+/*
+ * GPUProfiler.hpp
+ *
+ * GPU execution time of named sections of a frame (upload, each pass of a
+ * PassChain, the final draw), measured with GL_TIMESTAMP queries written
+ * before and after each section. Queries go into a ring with one slot per
+ * frame in flight and are read when their slot comes round again, a few
+ * frames later, so profiling never waits for the GPU. Timestamps, unlike
+ * GL_TIME_ELAPSED queries, may nest and overlap, so a multi-pass stage can
+ * time its sub-passes inside the chain's section for the whole stage.
+ */
+#ifndef GPUPROFILER_HPP
+#define GPUPROFILER_HPP
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Shader.hpp"  // GL types
+
+//!  GPUProfiler.
+/*!
+ Needs a current GL context for its whole lifetime. Sections with the same
+ name in one frame are added up.
+ */
+class GPUProfiler {
+public:
+    //! Constructor
+    /*! Results are read `frames` frames after they were recorded. */
+    explicit GPUProfiler(int frames = 3);
+    //! Destructor
+    /*! Deletes the queries. */
+    ~GPUProfiler();
+
+    //! beginFrame
+    /*! Start a new frame: collect the results of the frame recorded in
+        this ring slot last time round, then reuse its queries. */
+    void beginFrame();
+    //! begin
+    /*! Start section `name`. */
+    void begin(const std::string& name);
+    //! end
+    /*! End the innermost open section called `name`. */
+    void end(const std::string& name);
+
+    //! ms
+    /*! Latest GPU time of section `name` in milliseconds; -1 if none has
+        been collected yet. */
+    double ms(const std::string& name) const;
+    //! supported
+    /*! False if the context has no timestamp counter; sections then
+        record nothing. */
+    bool supported() const { return m_supported; }
+    //! dropped
+    /*! Frames whose results were still not available when their slot was
+        reused (the GPU was more than `frames` frames behind); they are
+        skipped rather than waited for. */
+    uint64_t dropped() const { return m_dropped; }
+
+private:
+    struct Section {
+        std::string name;
+        GLuint start, end;
+        bool open;
+    };
+    struct Frame {
+        std::vector<GLuint> queries;  // grows to the most a frame used
+        size_t used = 0;
+        std::vector<Section> sections;
+    };
+
+    GLuint query(Frame& frame);
+    void collect(Frame& frame);
+
+    std::vector<Frame> m_frames;
+    int m_current;
+    bool m_supported;
+    uint64_t m_dropped;
+    std::map<std::string, double> m_ms;
+};
+
+#endif
@@ -0,0 +1,128 @@
+#include "HeadlessContext.hpp"
+
+#include <cstring>
+
+#ifdef HAVE_EGL
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#endif
+
+HeadlessContext::HeadlessContext() : m_display(nullptr), m_context(nullptr) {}
+
+HeadlessContext::~HeadlessContext() { destroy(); }
+
+#ifdef HAVE_EGL
+
+namespace {
+
+bool hasExtension(const char* list, const char* name) {
+    if (list == nullptr) return false;
+    const size_t len = strlen(name);
+    for (const char* p = strstr(list, name); p; p = strstr(p + len, name)) {
+        if ((p == list || p[-1] == ' ') && (p[len] == ' ' || p[len] == '\0'))
+            return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+bool HeadlessContext::create() {
+    // Mesa's surfaceless platform needs neither X11/Wayland nor a GPU;
+    // otherwise try whatever the default display is.
+    EGLDisplay display = EGL_NO_DISPLAY;
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY,
+                                                  EGL_EXTENSIONS);
+    bool surfacelessPlatform =
+        hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless");
+    if (surfacelessPlatform) {
+        PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+            (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress(
+                "eglGetPlatformDisplayEXT");
+        if (getPlatformDisplay != nullptr)
+            display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA,
+                                         EGL_DEFAULT_DISPLAY, nullptr);
+        surfacelessPlatform = display != EGL_NO_DISPLAY;
+    }
+    if (display == EGL_NO_DISPLAY) display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        m_error = "no EGL display";
+        return false;
+    }
+    m_display = display;
+    if (!hasExtension(eglQueryString(display, EGL_EXTENSIONS),
+                      "EGL_KHR_surfaceless_context")) {
+        m_error = "EGL_KHR_surfaceless_context not supported";
+        destroy();
+        return false;
+    }
+
+    // No surface will ever be created, so any surface type will do.
+    const EGLint configAttribs[] = {EGL_SURFACE_TYPE, 0,
+                                    EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                    EGL_NONE};
+    EGLConfig config;
+    EGLint configs = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configs) ||
+        configs < 1 || !eglBindAPI(EGL_OPENGL_API)) {
+        m_error = "no desktop OpenGL config";
+        destroy();
+        return false;
+    }
+    // Same version and profile as the GLFW window (EGL 1.5 names, equal
+    // to the EGL_KHR_create_context ones).
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3, EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK,
+        EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT, EGL_NONE};
+    EGLContext context =
+        eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        m_error = "could not create an OpenGL 3.3 core context";
+        destroy();
+        return false;
+    }
+    m_context = context;
+    if (!eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        m_error = "could not make the context current";
+        destroy();
+        return false;
+    }
+
+    const char* vendor = eglQueryString(display, EGL_VENDOR);
+    m_description = "EGL " + std::to_string(major) + "." +
+                    std::to_string(minor) +
+                    (surfacelessPlatform ? " surfaceless" : " default display");
+    if (vendor != nullptr) m_description += std::string(" (") + vendor + ")";
+    return true;
+}
+
+void HeadlessContext::destroy() {
+    if (m_display == nullptr) return;
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE,
+                   EGL_NO_CONTEXT);
+    if (m_context != nullptr) eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+    m_context = nullptr;
+    m_display = nullptr;
+}
+
+HeadlessContext::Proc HeadlessContext::procAddress(const char* name) {
+    return eglGetProcAddress(name);
+}
+
+#else  // !HAVE_EGL
+
+bool HeadlessContext::create() {
+    m_error = "built without EGL";
+    return false;
+}
+
+void HeadlessContext::destroy() {}
+
+HeadlessContext::Proc HeadlessContext::procAddress(const char*) {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,57 @@
+/*
+ * HeadlessContext.hpp
+ *
+ * OpenGL 3.3 core context without a window or display server, for --headless
+ * runs on servers: EGL on Mesa's surfaceless platform (works with llvmpipe
+ * when there is no GPU), or on the default EGL display with
+ * EGL_KHR_surfaceless_context. There is no default framebuffer, so
+ * everything has to render into FBOs.
+ *
+ * Only available when built with EGL (HAVE_EGL, set by CMake when it finds
+ * libEGL); otherwise create() fails and callers fall back to a hidden GLFW
+ * window.
+ */
+#ifndef HEADLESSCONTEXT_HPP
+#define HEADLESSCONTEXT_HPP
+
+#include <string>
+
+//!  HeadlessContext.
+/*!
+ create() makes the context current on the calling thread; it stays
+ current until destroy() or destruction.
+ */
+class HeadlessContext {
+public:
+    HeadlessContext();
+    //! Destructor
+    /*! Calls destroy(). */
+    ~HeadlessContext();
+
+    //! create
+    /*! Create the context and make it current. False (with the reason in
+        error()) if EGL is unavailable or has no suitable display. */
+    bool create();
+    //! destroy
+    /*! Release the context and the display connection. */
+    void destroy();
+
+    typedef void (*Proc)(void);
+    //! procAddress
+    /*! GL entry point lookup for gladLoadGL(). */
+    static Proc procAddress(const char* name);
+
+    //! description
+    /*! e.g. "EGL 1.5 surfaceless (Mesa)", for the log. */
+    const std::string& description() const { return m_description; }
+    //! error
+    const std::string& error() const { return m_error; }
+
+private:
+    void* m_display;  // EGLDisplay
+    void* m_context;  // EGLContext
+    std::string m_description;
+    std::string m_error;
+};
+
+#endif
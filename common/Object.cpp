@@ -21,13 +21,15 @@ Object::Object(){
     transform = transMat * rotMat * scaleMat;
     
     shader = NULL;
+    ownsShader = false;
     
 }
-void Object::setShader(Shader* newshader){
-    if(shader!=NULL)
+void Object::setShader(Shader* newshader, bool takeOwnership){
+    if(shader!=NULL && ownsShader && shader!=newshader)
         delete shader;
     
     shader = newshader;
+    ownsShader = takeOwnership;
     
 }
 glm::mat4 Object::getTransform(){
@@ -0,0 +1,138 @@
+#include "PassChain.hpp"
+
+#include <algorithm>
+#include <sstream>
+
+PassChain::PassChain(RenderTargetPool& pool, GPUProfiler* profiler)
+    : m_pool(pool), m_profiler(profiler), m_held(nullptr) {}
+
+PassChain::~PassChain() { clear(); }
+
+void PassChain::clear() {
+    m_passes.clear();
+    m_pool.release(m_held);
+    m_held = nullptr;
+}
+
+void PassChain::addPass(const std::string& name, TextureShader* shader,
+                        GLenum format, int divisor) {
+    Pass pass;
+    pass.name = name;
+    pass.shader = shader;
+    pass.compute = nullptr;
+    pass.stage = nullptr;
+    pass.format = format;
+    pass.divisor = divisor < 1 ? 1 : divisor;
+    m_passes.push_back(pass);
+}
+
+void PassChain::addComputePass(const std::string& name,
+                               ComputeShader* shader, GLenum format) {
+    addPass(name, nullptr, format);
+    m_passes.back().compute = shader;
+}
+
+void PassChain::addStage(const std::string& name, PassStage* stage) {
+    addPass(name, nullptr, GL_RGBA8);
+    m_passes.back().stage = stage;
+}
+
+void PassChain::begin(const Pass& pass) {
+    if (m_profiler != nullptr) m_profiler->begin(pass.name);
+}
+
+void PassChain::end(const Pass& pass) {
+    if (m_profiler != nullptr) m_profiler->end(pass.name);
+}
+
+TextureShader* PassChain::run(Texture* source) {
+    // Last frame's Quad draw has been submitted; its input can be reused.
+    m_pool.release(m_held);
+    m_held = nullptr;
+    if (m_passes.empty()) return nullptr;
+
+    const int width = source->getWidth(), height = source->getHeight();
+    Texture* input = source;
+    const size_t last = m_passes.size() - 1;
+    if (last > 0) {
+        // The Quad draw goes wherever the caller had bound (the window or
+        // a headless target).
+        GLint viewport[4], framebuffer = 0;
+        glGetIntegerv(GL_VIEWPORT, viewport);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &framebuffer);
+        RenderTarget* previous = nullptr;
+        for (size_t i = 0; i < last; ++i) {
+            const Pass& pass = m_passes[i];
+            RenderTarget* target;
+            begin(pass);
+            if (pass.stage != nullptr) {
+                target = pass.stage->render(input, m_pool, m_profiler);
+            } else {
+                const int tw = (width + pass.divisor - 1) / pass.divisor;
+                const int th = (height + pass.divisor - 1) / pass.divisor;
+                target = m_pool.acquire(tw, th, pass.format);
+                if (pass.compute != nullptr) {
+                    pass.compute->dispatch(input, target->texture,
+                                           pass.format);
+                } else {
+                    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+                    glViewport(0, 0, tw, th);
+                    glClear(GL_COLOR_BUFFER_BIT);
+                    pass.shader->setTexture(input);
+                    pass.shader->bind();
+                    // fullscreenPass.vert derives the triangle from
+                    // gl_VertexID, so the VAO bound for the Quad is enough.
+                    glDrawArrays(GL_TRIANGLES, 0, 3);
+                }
+            }
+            end(pass);
+            // Ping-pong: the input is free once this pass has read it.
+            m_pool.release(previous);
+            previous = target;
+            input = target->texture;
+        }
+        m_held = previous;
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)framebuffer);
+        glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+    }
+    m_passes[last].shader->setTexture(input);
+    return m_passes[last].shader;
+}
+
+void PassChain::beginFinalPass() {
+    if (!m_passes.empty()) begin(m_passes.back());
+}
+
+void PassChain::endFinalPass() {
+    if (!m_passes.empty()) end(m_passes.back());
+}
+
+double PassChain::passMs(int i) const {
+    return m_profiler != nullptr ? m_profiler->ms(m_passes[i].name) : -1.0;
+}
+
+std::vector<std::string> PassChain::timerNames() const {
+    std::vector<std::string> names;
+    auto add = [&](const std::string& name) {
+        if (std::find(names.begin(), names.end(), name) == names.end())
+            names.push_back(name);
+    };
+    for (const Pass& pass : m_passes) {
+        add(pass.name);
+        if (pass.stage != nullptr)
+            for (const std::string& name : pass.stage->timerNames())
+                add(name);
+    }
+    return names;
+}
+
+std::string PassChain::timingSummary() const {
+    std::ostringstream out;
+    const std::vector<std::string> names = timerNames();
+    for (size_t i = 0; i < names.size(); ++i) {
+        if (i > 0) out << "|";
+        out << names[i] << ":"
+            << (m_profiler != nullptr ? m_profiler->ms(names[i]) : -1.0);
+    }
+    return out.str();
+}
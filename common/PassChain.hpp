@@ -0,0 +1,144 @@
+/*
+ * PassChain.hpp
+ *
+ * Ordered list of GPU fragment passes over the video texture. Every pass
+ * but the last renders a full-screen triangle into a pooled render target
+ * (ping-ponging between two per size and format); the last pass is drawn
+ * through the Quad, sampling the previous pass's output. Intermediate
+ * passes can also be compute shaders writing the target as an image, or
+ * stages that run several sub-passes of their own. With a GPUProfiler,
+ * each pass is a profiler section named after it.
+ */
+#ifndef PASSCHAIN_HPP
+#define PASSCHAIN_HPP
+
+#include <string>
+#include <vector>
+
+#include "ComputeShader.hpp"
+#include "GPUProfiler.hpp"
+#include "RenderTargetPool.hpp"
+#include "TextureShader.hpp"
+
+//!  PassStage.
+/*!
+ An intermediate pass made of several draws (e.g. a filter that iterates),
+ added with PassChain::addStage(). The chain times the stage as a whole;
+ the stage can add sections for its sub-passes.
+ */
+class PassStage {
+public:
+    virtual ~PassStage() {}
+
+    //! prepare
+    /*! Start (or, with `wait`, finish) building the stage's programs.
+        True once all of them are linked. */
+    virtual bool prepare(bool wait) = 0;
+    //! failed
+    /*! True if one of the programs failed to build. */
+    virtual bool failed() const = 0;
+    //! render
+    /*! Run the stage on `input` and return the target holding the result,
+        acquired from `pool`; the caller releases it. Only called once
+        prepare() returned true. May change the framebuffer and viewport
+        bindings. `profiler` may be null. */
+    virtual RenderTarget* render(Texture* input, RenderTargetPool& pool,
+                                 GPUProfiler* profiler) = 0;
+    //! timerNames
+    /*! Profiler sections render() records, in order. */
+    virtual std::vector<std::string> timerNames() const = 0;
+};
+
+//!  PassChain.
+/*!
+ Intermediate passes must be built with fullscreenPass.vert, which keeps
+ the source's top-down row order in the render target; the last one with
+ the Quad's vertex shader. Shaders are not owned.
+ */
+class PassChain {
+public:
+    //! Constructor
+    /*! Intermediate targets come from `pool`, which must outlive the
+        chain, and so must `profiler` (optional). */
+    explicit PassChain(RenderTargetPool& pool,
+                       GPUProfiler* profiler = nullptr);
+    //! Destructor
+    /*! Releases the targets still held. */
+    ~PassChain();
+
+    //! clear
+    /*! Remove every pass. */
+    void clear();
+    //! addPass
+    /*! Append a pass. `format` (GL_R8 or GL_RGBA8) is the render target
+        format used when the pass is not the last one; its size is the
+        source size divided by `divisor`, rounded up (for reductions). */
+    void addPass(const std::string& name, TextureShader* shader,
+                 GLenum format = GL_RGBA8, int divisor = 1);
+    //! addComputePass
+    /*! Append a compute pass writing a `format` target. It cannot be the
+        last pass, since the Quad draw needs a fragment shader. */
+    void addComputePass(const std::string& name, ComputeShader* shader,
+                        GLenum format = GL_RGBA8);
+    //! addStage
+    /*! Append a multi-pass stage (not owned). Like a compute pass, it
+        cannot be the last pass. */
+    void addStage(const std::string& name, PassStage* stage);
+
+    //! run
+    /*! Render every pass but the last from `source` into render targets
+        and point the last pass's shader at the result. Returns that shader
+        for the Quad to draw with, or nullptr if the chain is empty. */
+    TextureShader* run(Texture* source);
+
+    //! output
+    /*! Render target the last pass samples after run(), i.e. the result
+        of every pass but the last in the source's size and row order;
+        nullptr if the last pass reads the source directly. Valid until
+        the next run(). */
+    RenderTarget* output() const { return m_held; }
+
+    //! beginFinalPass
+    /*! Start timing the Quad draw that runs the last pass. */
+    void beginFinalPass();
+    //! endFinalPass
+    /*! Stop timing the Quad draw. */
+    void endFinalPass();
+
+    //! passCount
+    int passCount() const { return (int)m_passes.size(); }
+    //! passName
+    const std::string& passName(int i) const { return m_passes[i].name; }
+    //! passMs
+    /*! Latest GPU time of pass `i` in milliseconds (summed over passes of
+        the same name), from the profiler; -1 until one has been collected
+        or without a profiler. */
+    double passMs(int i) const;
+    //! timerNames
+    /*! Profiler sections of a run, in order and without duplicates: each
+        pass, followed by its sub-passes for stages. */
+    std::vector<std::string> timerNames() const;
+    //! timingSummary
+    /*! "name:ms|name:ms|..." over timerNames(), for CSV output. */
+    std::string timingSummary() const;
+
+private:
+    struct Pass {
+        std::string name;
+        TextureShader* shader;
+        ComputeShader* compute;  // instead of `shader` for compute passes
+        PassStage* stage;        // or for multi-pass stages
+        GLenum format;
+        int divisor;
+    };
+
+    void begin(const Pass& pass);
+    void end(const Pass& pass);
+
+    RenderTargetPool& m_pool;
+    GPUProfiler* m_profiler;
+    std::vector<Pass> m_passes;
+    RenderTarget* m_held;  // input of the last pass, read by the Quad draw
+};
+
+#endif
@@ -0,0 +1,76 @@
+#include "PresentPacer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+PresentPacer::PresentPacer(double periodMs)
+    : m_periodMs(std::max(0.0, periodMs)),
+      m_period(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double, std::milli>(m_periodMs))),
+      m_started(false),
+      m_presentedOnce(false),
+      m_intervalMs(-1.0),
+      m_intervals(0),
+      m_misses(0),
+      m_sum(0.0),
+      m_sumSquares(0.0),
+      m_min(0.0),
+      m_max(0.0) {}
+
+void PresentPacer::beginFrame() {
+    if (m_periodMs <= 0.0) return;
+    Clock::time_point now = Clock::now();
+    if (!m_started) {
+        m_started = true;
+        m_slot = now;
+        return;
+    }
+    m_slot += m_period;
+    // Overran by more than a slot: skip to the current one.
+    if (m_slot + m_period < now) {
+        m_slot += ((now - m_slot) / m_period) * m_period;
+    }
+    if (m_slot > now) std::this_thread::sleep_until(m_slot);
+}
+
+bool PresentPacer::presented() {
+    Clock::time_point now = Clock::now();
+    if (m_presentedOnce) {
+        m_intervalMs =
+            std::chrono::duration<double, std::milli>(now - m_lastPresent)
+                .count();
+        if (m_intervals == 0) {
+            m_min = m_max = m_intervalMs;
+        } else {
+            m_min = std::min(m_min, m_intervalMs);
+            m_max = std::max(m_max, m_intervalMs);
+        }
+        ++m_intervals;
+        m_sum += m_intervalMs;
+        m_sumSquares += m_intervalMs * m_intervalMs;
+    }
+    m_presentedOnce = true;
+    m_lastPresent = now;
+
+    bool missed = m_periodMs > 0.0 && now > m_slot + m_period;
+    if (missed) ++m_misses;
+    return missed;
+}
+
+double PresentPacer::meanIntervalMs() const {
+    return m_intervals > 0 ? m_sum / (double)m_intervals : -1.0;
+}
+
+double PresentPacer::jitterMs() const {
+    if (m_intervals < 2) return 0.0;
+    double mean = m_sum / (double)m_intervals;
+    double var = (m_sumSquares - m_sum * mean) / (double)(m_intervals - 1);
+    return std::sqrt(std::max(0.0, var));
+}
+
+double PresentPacer::maxJitterMs() const {
+    if (m_intervals == 0) return 0.0;
+    if (m_periodMs <= 0.0) return (m_max - m_min) / 2.0;
+    return std::max(m_max - m_periodMs, m_periodMs - m_min);
+}
@@ -0,0 +1,78 @@
+/*
+ * PresentPacer.hpp
+ *
+ * Presentation timing for the render loop. With a target period, frames
+ * start on a fixed grid (the loop sleeps until its slot) and must present
+ * within one period of their slot; later presents count as deadline
+ * misses, and the slots they overran are skipped instead of bursting to
+ * catch up. Either way the intervals between presents are recorded, so
+ * their jitter can be reported for vsync-throttled, unthrottled and paced
+ * runs alike.
+ */
+#ifndef PRESENTPACER_HPP
+#define PRESENTPACER_HPP
+
+#include <chrono>
+#include <cstdint>
+
+//!  PresentPacer.
+/*!
+ Call beginFrame() before the frame's work and presented() right after it
+ was presented (the swap returned, or the last draw was submitted for
+ runs without a window).
+ */
+class PresentPacer {
+public:
+    //! Constructor
+    /*! Frames are paced to `periodMs`; 0 only measures. */
+    explicit PresentPacer(double periodMs = 0.0);
+
+    //! beginFrame
+    /*! Sleep until the frame's slot when pacing. Not part of the frame:
+        call it before starting the frame timer. */
+    void beginFrame();
+    //! presented
+    /*! Record the present of the frame begun last. Returns whether it
+        missed its deadline (never without a period). */
+    bool presented();
+
+    //! periodMs
+    double periodMs() const { return m_periodMs; }
+    //! intervalMs
+    /*! Time between the last two presents; -1 before the second one. */
+    double intervalMs() const { return m_intervalMs; }
+    //! intervals
+    /*! Present-to-present intervals recorded so far. */
+    int64_t intervals() const { return m_intervals; }
+    //! misses
+    /*! Presents later than one period after their slot. */
+    int64_t misses() const { return m_misses; }
+    //! meanIntervalMs
+    double meanIntervalMs() const;
+    //! jitterMs
+    /*! Standard deviation of the present-to-present intervals. */
+    double jitterMs() const;
+    //! maxJitterMs
+    /*! Largest deviation of an interval from the period; without a
+        period, half the spread between the shortest and longest
+        interval. */
+    double maxJitterMs() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    double m_periodMs;
+    Clock::duration m_period;
+    Clock::time_point m_slot;  // start of the current frame's slot
+    Clock::time_point m_lastPresent;
+    bool m_started;
+    bool m_presentedOnce;
+
+    double m_intervalMs;
+    int64_t m_intervals;
+    int64_t m_misses;
+    double m_sum, m_sumSquares;  // of the intervals, for mean and jitter
+    double m_min, m_max;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include "RenderTargetPool.hpp"
+
+#include <stdio.h>
+
+RenderTargetPool::RenderTargetPool() : m_hits(0), m_misses(0) {}
+
+RenderTargetPool::~RenderTargetPool() { clear(); }
+
+RenderTarget* RenderTargetPool::acquire(int width, int height,
+                                        GLenum format) {
+    for (RenderTarget* t : m_targets) {
+        if (!t->inUse && t->width == width && t->height == height &&
+            t->format == format) {
+            ++m_hits;
+            t->inUse = true;
+            return t;
+        }
+    }
+    ++m_misses;
+    RenderTarget* t = new RenderTarget();
+    t->texture = new Texture(width, height, format);
+    t->width = width;
+    t->height = height;
+    t->format = format;
+    t->inUse = true;
+
+    glGenFramebuffers(1, &t->framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, t->framebuffer);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                           GL_TEXTURE_2D, t->texture->getTextureID(), 0);
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+        printf("RenderTargetPool: %dx%d target incomplete (0x%x)\n", width,
+               height, status);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    m_targets.push_back(t);
+    return t;
+}
+
+void RenderTargetPool::release(RenderTarget* target) {
+    if (target != nullptr) target->inUse = false;
+}
+
+void RenderTargetPool::clear() {
+    for (RenderTarget* t : m_targets) {
+        glDeleteFramebuffers(1, &t->framebuffer);
+        delete t->texture;
+        delete t;
+    }
+    m_targets.clear();
+    m_hits = 0;
+    m_misses = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * RenderTargetPool.hpp
+ *
+ * GPU counterpart of FramePool: framebuffer-attached textures for the
+ * passes of a PassChain, recycled by size and format. A target is taken
+ * with acquire() and handed back with release() once nothing reads it any
+ * more; after the first frame at a given resolution the chain allocates
+ * nothing.
+ */
+#ifndef RENDERTARGETPOOL_HPP
+#define RENDERTARGETPOOL_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "Shader.hpp"  // GL types
+#include "Texture.hpp"
+
+//!  RenderTarget.
+/*!
+ A texture with its framebuffer. Owned by the pool.
+ */
+struct RenderTarget {
+    Texture* texture;
+    GLuint framebuffer;
+    int width;
+    int height;
+    GLenum format;  // GL_R8, GL_RGBA8 or GL_RGBA16F
+    bool inUse;
+};
+
+//!  RenderTargetPool.
+/*!
+ Needs a current GL context for its whole lifetime.
+ */
+class RenderTargetPool {
+public:
+    RenderTargetPool();
+    //! Destructor
+    /*! Deletes every target, in use or not. */
+    ~RenderTargetPool();
+
+    //! acquire
+    /*! A free target of the given size and format, created if none is
+        free. Its contents are left over from the previous use. */
+    RenderTarget* acquire(int width, int height, GLenum format);
+    //! release
+    /*! Return a target to the pool. Null is ignored. */
+    void release(RenderTarget* target);
+
+    //! hits
+    /*! Requests served by a recycled target. */
+    uint64_t hits() const { return m_hits; }
+    //! misses
+    /*! Requests that had to create a target. */
+    uint64_t misses() const { return m_misses; }
+    //! count
+    /*! Targets held by the pool. */
+    int count() const { return (int)m_targets.size(); }
+    //! clear
+    /*! Delete every target and reset the statistics. No target may be in
+        use. */
+    void clear();
+
+private:
+    std::vector<RenderTarget*> m_targets;
+    uint64_t m_hits;
+    uint64_t m_misses;
+};
+
+#endif
@@ -1,154 +1,205 @@
-
-// Include standard headers
-#include <string>
-// Include GLEW
-//#include <GL/glew.h>
-#include <common/Shader.hpp>
-
-#include <stdio.h>
-#include <string>
-#include <vector>
-#include <iostream>
-#include <fstream>
-#include <algorithm>
-using namespace std;
-
-#include <stdlib.h>
-#include <string.h>
-
-//#include <GL/glew.h>
-
-
-GLuint Shader::LoadShaders(const char * vertex_file_path,const char * fragment_file_path){
-	
-	// Create the shaders
-	GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
-	GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
-	
-	// Read the Vertex Shader code from the file
-	std::string VertexShaderCode;
-	std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
-	if(VertexShaderStream.is_open()){
-		std::string Line = "";
-		while(getline(VertexShaderStream, Line))
-			VertexShaderCode += "\n" + Line;
-		VertexShaderStream.close();
-	}else{
-		printf("Impossible to open %s. Are you in the right directory ? Don't forget to read the FAQ !\n", vertex_file_path);
-		getchar();
-		return 0;
-	}
-	
-	// Read the Fragment Shader code from the file
-	std::string FragmentShaderCode;
-	std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
-	if(FragmentShaderStream.is_open()){
-		std::string Line = "";
-		while(getline(FragmentShaderStream, Line))
-			FragmentShaderCode += "\n" + Line;
-		FragmentShaderStream.close();
-	}
-	
-	GLint Result = GL_FALSE;
-	int InfoLogLength;
-	
-	
-	// Compile Vertex Shader
-	printf("Compiling shader : %s\n", vertex_file_path);
-	char const * VertexSourcePointer = VertexShaderCode.c_str();
-	glShaderSource(VertexShaderID, 1, &VertexSourcePointer , NULL);
-	glCompileShader(VertexShaderID);
-	
-	// Check Vertex Shader
-	glGetShaderiv(VertexShaderID, GL_COMPILE_STATUS, &Result);
-	glGetShaderiv(VertexShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-	if ( InfoLogLength > 0 ){
-		std::vector<char> VertexShaderErrorMessage(InfoLogLength+1);
-		glGetShaderInfoLog(VertexShaderID, InfoLogLength, NULL, &VertexShaderErrorMessage[0]);
-		printf("%s\n", &VertexShaderErrorMessage[0]);
-	}
-	
-	
-	
-	// Compile Fragment Shader
-	printf("Compiling shader : %s\n", fragment_file_path);
-	char const * FragmentSourcePointer = FragmentShaderCode.c_str();
-	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer , NULL);
-	glCompileShader(FragmentShaderID);
-	
-	// Check Fragment Shader
-	glGetShaderiv(FragmentShaderID, GL_COMPILE_STATUS, &Result);
-	glGetShaderiv(FragmentShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-	if ( InfoLogLength > 0 ){
-		std::vector<char> FragmentShaderErrorMessage(InfoLogLength+1);
-		glGetShaderInfoLog(FragmentShaderID, InfoLogLength, NULL, &FragmentShaderErrorMessage[0]);
-		printf("%s\n", &FragmentShaderErrorMessage[0]);
-	}
-	
-	
-	
-	// Link the program
-	printf("Linking program\n");
-	GLuint ProgramID = glCreateProgram();
-	glAttachShader(ProgramID, VertexShaderID);
-	glAttachShader(ProgramID, FragmentShaderID);
-	glLinkProgram(ProgramID);
-	
-	// Check the program
-	glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
-	glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
-	if ( InfoLogLength > 0 ){
-		std::vector<char> ProgramErrorMessage(InfoLogLength+1);
-		glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
-		printf("%s\n", &ProgramErrorMessage[0]);
-	}
-	
-	
-	glDetachShader(ProgramID, VertexShaderID);
-	glDetachShader(ProgramID, FragmentShaderID);
-	
-	glDeleteShader(VertexShaderID);
-	glDeleteShader(FragmentShaderID);
-	
-	return ProgramID;
-}
-
-
-
-void Shader::initShaders(std::string vertexshaderName, std::string fragmentshaderName){
-	programID = LoadShaders(vertexshaderName.c_str(), fragmentshaderName.c_str());
-	m_MVPID = glGetUniformLocation(programID, "MVP");
-	m_MID = glGetUniformLocation(programID, "M");
-	m_VID = glGetUniformLocation(programID, "V");
-	m_PID = glGetUniformLocation(programID, "P");
-	
-}
-
-void Shader::updateMatrices(glm::mat4 MVP,glm::mat4 M,glm::mat4 V,glm::mat4 P){
-	
-	glUniformMatrix4fv(m_MVPID, 1, GL_FALSE, &MVP[0][0]);
-	glUniformMatrix4fv(m_MID, 1, GL_FALSE, &M[0][0]);
-	glUniformMatrix4fv(m_VID, 1, GL_FALSE, &V[0][0]);
-	glUniformMatrix4fv(m_PID, 1, GL_FALSE, &P[0][0]);
-	
-}
-
-
-void Shader::updateMVP(glm::mat4 MVP){
-	
-	glUniformMatrix4fv(m_MVPID, 1, GL_FALSE, &MVP[0][0]);
-	
-}
-
-Shader::~Shader(){
-	
-	glDeleteProgram(programID);
-	
-}
-
-void Shader::bind(){
-	
-	// Use our shader
-	glUseProgram(programID);
-	
-}
+
+// Include standard headers
+#include <string>
+// Include GLEW
+//#include <GL/glew.h>
+#include <common/Shader.hpp>
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+using namespace std;
+
+#include <stdlib.h>
+#include <string.h>
+
+//#include <GL/glew.h>
+
+
+GLuint Shader::LoadShaders(const char * vertex_file_path,const char * fragment_file_path){
+	
+	// Create the shaders
+	GLuint VertexShaderID = glCreateShader(GL_VERTEX_SHADER);
+	GLuint FragmentShaderID = glCreateShader(GL_FRAGMENT_SHADER);
+	
+	// Read the Vertex Shader code from the file
+	std::string VertexShaderCode;
+	std::ifstream VertexShaderStream(vertex_file_path, std::ios::in);
+	if(VertexShaderStream.is_open()){
+		std::string Line = "";
+		while(getline(VertexShaderStream, Line))
+			VertexShaderCode += "\n" + Line;
+		VertexShaderStream.close();
+	}else{
+		printf("Impossible to open %s. Are you in the right directory ? Don't forget to read the FAQ !\n", vertex_file_path);
+		getchar();
+		return 0;
+	}
+	
+	// Read the Fragment Shader code from the file
+	std::string FragmentShaderCode;
+	std::ifstream FragmentShaderStream(fragment_file_path, std::ios::in);
+	if(FragmentShaderStream.is_open()){
+		std::string Line = "";
+		while(getline(FragmentShaderStream, Line))
+			FragmentShaderCode += "\n" + Line;
+		FragmentShaderStream.close();
+	}
+	
+	GLint Result = GL_FALSE;
+	int InfoLogLength;
+	
+	
+	// Compile Vertex Shader
+	printf("Compiling shader : %s\n", vertex_file_path);
+	char const * VertexSourcePointer = VertexShaderCode.c_str();
+	glShaderSource(VertexShaderID, 1, &VertexSourcePointer , NULL);
+	glCompileShader(VertexShaderID);
+	
+	// Check Vertex Shader
+	glGetShaderiv(VertexShaderID, GL_COMPILE_STATUS, &Result);
+	glGetShaderiv(VertexShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if ( InfoLogLength > 0 ){
+		std::vector<char> VertexShaderErrorMessage(InfoLogLength+1);
+		glGetShaderInfoLog(VertexShaderID, InfoLogLength, NULL, &VertexShaderErrorMessage[0]);
+		printf("%s\n", &VertexShaderErrorMessage[0]);
+	}
+	
+	
+	
+	// Compile Fragment Shader
+	printf("Compiling shader : %s\n", fragment_file_path);
+	char const * FragmentSourcePointer = FragmentShaderCode.c_str();
+	glShaderSource(FragmentShaderID, 1, &FragmentSourcePointer , NULL);
+	glCompileShader(FragmentShaderID);
+	
+	// Check Fragment Shader
+	glGetShaderiv(FragmentShaderID, GL_COMPILE_STATUS, &Result);
+	glGetShaderiv(FragmentShaderID, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if ( InfoLogLength > 0 ){
+		std::vector<char> FragmentShaderErrorMessage(InfoLogLength+1);
+		glGetShaderInfoLog(FragmentShaderID, InfoLogLength, NULL, &FragmentShaderErrorMessage[0]);
+		printf("%s\n", &FragmentShaderErrorMessage[0]);
+	}
+	
+	
+	
+	// Link the program
+	printf("Linking program\n");
+	GLuint ProgramID = glCreateProgram();
+	glAttachShader(ProgramID, VertexShaderID);
+	glAttachShader(ProgramID, FragmentShaderID);
+	glLinkProgram(ProgramID);
+	
+	// Check the program
+	glGetProgramiv(ProgramID, GL_LINK_STATUS, &Result);
+	glGetProgramiv(ProgramID, GL_INFO_LOG_LENGTH, &InfoLogLength);
+	if ( InfoLogLength > 0 ){
+		std::vector<char> ProgramErrorMessage(InfoLogLength+1);
+		glGetProgramInfoLog(ProgramID, InfoLogLength, NULL, &ProgramErrorMessage[0]);
+		printf("%s\n", &ProgramErrorMessage[0]);
+	}
+	
+	
+	glDetachShader(ProgramID, VertexShaderID);
+	glDetachShader(ProgramID, FragmentShaderID);
+	
+	glDeleteShader(VertexShaderID);
+	glDeleteShader(FragmentShaderID);
+	
+	return ProgramID;
+}
+
+
+
+void Shader::initShaders(std::string vertexshaderName, std::string fragmentshaderName){
+	programID = LoadShaders(vertexshaderName.c_str(), fragmentshaderName.c_str());
+	cacheUniforms();
+	
+}
+
+void Shader::cacheUniforms(){
+	
+	m_uniforms.clear();
+	GLint count = 0, maxLength = 0;
+	if (programID != 0) {
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORMS, &count);
+		glGetProgramiv(programID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+	}
+	std::vector<char> name(maxLength + 1, '\0');
+	for (GLint i = 0; i < count; ++i) {
+		GLint size = 0;
+		GLenum type = 0;
+		GLsizei length = 0;
+		glGetActiveUniform(programID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+		std::string uniform(name.data(), length);
+		// Members of uniform blocks are active too but have no location.
+		GLint location = glGetUniformLocation(programID, uniform.c_str());
+		if (location < 0)
+			continue;
+		m_uniforms[uniform] = location;
+		// Arrays are reported as "name[0]"; also accept the bare name.
+		if (uniform.size() > 3 && uniform.compare(uniform.size() - 3, 3, "[0]") == 0)
+			m_uniforms[uniform.substr(0, uniform.size() - 3)] = location;
+	}
+	
+	m_MVPID = uniformLocation("MVP");
+	m_MID = uniformLocation("M");
+	m_VID = uniformLocation("V");
+	m_PID = uniformLocation("P");
+	
+	// Per-frame parameters come from the shared uniform buffer. GLSL 330
+	// has no layout(binding) for blocks, so attach it here.
+	if (programID != 0) {
+		GLuint block = glGetUniformBlockIndex(programID, "FrameParams");
+		if (block != GL_INVALID_INDEX)
+			glUniformBlockBinding(programID, block, kFrameBlockBinding);
+	}
+	
+}
+
+GLint Shader::uniformLocation(const std::string& name) const{
+	
+	auto it = m_uniforms.find(name);
+	return it != m_uniforms.end() ? it->second : -1;
+	
+}
+
+void Shader::updateMatrices(glm::mat4 MVP,glm::mat4 M,glm::mat4 V,glm::mat4 P){
+	
+	glUniformMatrix4fv(m_MVPID, 1, GL_FALSE, &MVP[0][0]);
+	glUniformMatrix4fv(m_MID, 1, GL_FALSE, &M[0][0]);
+	glUniformMatrix4fv(m_VID, 1, GL_FALSE, &V[0][0]);
+	glUniformMatrix4fv(m_PID, 1, GL_FALSE, &P[0][0]);
+	
+}
+
+
+void Shader::updateMVP(glm::mat4 MVP){
+	
+	glUniformMatrix4fv(m_MVPID, 1, GL_FALSE, &MVP[0][0]);
+	
+}
+
+void Shader::adoptProgram(GLuint program, bool ownsProgram){
+	programID = program;
+	m_ownsProgram = ownsProgram;
+	cacheUniforms();
+}
+
+Shader::~Shader(){
+	
+	if (m_ownsProgram)
+		glDeleteProgram(programID);
+	
+}
+
+void Shader::bind(){
+	
+	// Use our shader
+	glUseProgram(programID);
+	
+}
@@ -1,83 +1,104 @@
-/*
- * Shader.hpp
- *
- *  Class for representing shader implementation. Contains all the required function calls like create shaders, compile shaders.
- *  by Stefanie Zollmann
- *
- */
-
-#ifndef SHADER_HPP
-#define SHADER_HPP
-
-// Include standard headers
-#include <string>
-
-#include <glad/gl.h>
-
-#include <glm/glm.hpp>
-#include <glm/gtc/matrix_transform.hpp>
-
-
-//!  Shader.
-/*!
- Shader implementation. Contains all the required function calls like create shaders, compile shaders.
- */
-class Shader{
-	
-public:
-    //! Default constructor
-    /*! Does nothing at the moment */
-	Shader(){
-		
-	}
-    //! Constructor with shader source specification
-    /*! Creates the shaders from source, creates vertex and fragment shader at the same time. 
-        Uses different source file naming conventions*/
-	Shader(std::string vertexshaderName, std::string fragmentshaderName){
-		initShaders(vertexshaderName,fragmentshaderName);
-		
-	}
-    //! Constructor with shader source specification
-    /*! Creates the shaders from source, creates vertex and fragment shader at the same time. 
-     Assumes that fragment and vertex shader have the same names*/
-	Shader(std::string shaderName){
-		initShaders(shaderName+".vert",shaderName+".frag");
-		
-	}
-    
-    //! Destructor
-    /*! Virtual - write own destructor for each shader implementation*/
-    
-	virtual ~Shader();
-	
-    //! LoadShaders
-    /*! Does the actual shader loading and compiling*/
-	GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path);
-    //! initShaders
-    /*! init shaders*/
-	void initShaders(std::string vertexshaderName, std::string fragmentshaderName);
-	
-    //! updateMatrices
-    /*! Updates the values for the model-view projection matrix and the model and view matrix separately*/
-	void updateMatrices(glm::mat4 MVP,glm::mat4 M,glm::mat4 V, glm::mat4 P);
-	
-    //! updateMVP
-    /*! Updates the values for the model-view projection matrix*/
-	void updateMVP(glm::mat4 MVP);
-	
-    //! bind
-    /*! Shader binding, virtual */
-	virtual void bind();
-    
-protected:
-	GLuint programID;
-	GLuint m_MVPID;     //!<   all shader should get information about the MVP matrix
-	GLuint m_VID;       //!<   all shader should get information about the view matrix
-	GLuint m_MID;       //!<   all shader should get information about the model matrix
-    GLuint m_PID;       //!<   all shader should get information about the projection matrix
-     
-};
-
-
-
-#endif
+/*
+ * Shader.hpp
+ *
+ *  Class for representing shader implementation. Contains all the required function calls like create shaders, compile shaders.
+ *  by Stefanie Zollmann
+ *
+ */
+
+#ifndef SHADER_HPP
+#define SHADER_HPP
+
+// Include standard headers
+#include <map>
+#include <string>
+
+#include <glad/gl.h>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+
+//!  Shader.
+/*!
+ Shader implementation. Contains all the required function calls like create shaders, compile shaders.
+ */
+class Shader{
+	
+public:
+    //! Default constructor
+    /*! Does nothing at the moment */
+	Shader(){
+		
+	}
+    //! Constructor with shader source specification
+    /*! Creates the shaders from source, creates vertex and fragment shader at the same time. 
+        Uses different source file naming conventions*/
+	Shader(std::string vertexshaderName, std::string fragmentshaderName){
+		initShaders(vertexshaderName,fragmentshaderName);
+		
+	}
+    //! Constructor with shader source specification
+    /*! Creates the shaders from source, creates vertex and fragment shader at the same time. 
+     Assumes that fragment and vertex shader have the same names*/
+	Shader(std::string shaderName){
+		initShaders(shaderName+".vert",shaderName+".frag");
+		
+	}
+    
+    //! Destructor
+    /*! Virtual - write own destructor for each shader implementation*/
+    
+	virtual ~Shader();
+	
+    //! LoadShaders
+    /*! Does the actual shader loading and compiling*/
+	GLuint LoadShaders(const char * vertex_file_path,const char * fragment_file_path);
+    //! initShaders
+    /*! init shaders*/
+	void initShaders(std::string vertexshaderName, std::string fragmentshaderName);
+    //! adoptProgram
+    /*! Use an already linked program (e.g. from ShaderCache) instead of compiling one.
+        With ownsProgram false the destructor leaves the program alive for its owner. */
+	void adoptProgram(GLuint program, bool ownsProgram);
+    //! getProgramID
+    /*! The GL program this shader binds */
+	GLuint getProgramID() const { return programID; }
+    //! uniformLocation
+    /*! Location of an active uniform, looked up once when the program was linked or adopted.
+        -1 if the program has no such uniform; never calls into GL. */
+	GLint uniformLocation(const std::string& name) const;
+    //! kFrameBlockBinding
+    /*! Binding point every program's FrameParams uniform block is attached to (see FrameUniforms) */
+	static const GLuint kFrameBlockBinding = 0;
+	
+    //! updateMatrices
+    /*! Updates the values for the model-view projection matrix and the model and view matrix separately*/
+	void updateMatrices(glm::mat4 MVP,glm::mat4 M,glm::mat4 V, glm::mat4 P);
+	
+    //! updateMVP
+    /*! Updates the values for the model-view projection matrix*/
+	void updateMVP(glm::mat4 MVP);
+	
+    //! bind
+    /*! Shader binding, virtual */
+	virtual void bind();
+    
+protected:
+    //! cacheUniforms
+    /*! Fill the uniform location cache and attach the FrameParams block after (re)linking */
+	void cacheUniforms();
+
+	GLuint programID;
+	GLuint m_MVPID;     //!<   all shader should get information about the MVP matrix
+	GLuint m_VID;       //!<   all shader should get information about the view matrix
+	GLuint m_MID;       //!<   all shader should get information about the model matrix
+    GLuint m_PID;       //!<   all shader should get information about the projection matrix
+    bool m_ownsProgram = true;  //!< delete programID in the destructor
+    std::map<std::string, GLint> m_uniforms;  //!< active uniform name -> location
+     
+};
+
+
+
+#endif
@@ -0,0 +1,422 @@
+#include "ShaderCache.hpp"
+
+#include <sys/stat.h>
+
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace {
+
+const uint32_t kBinaryMagic = 0x42505643;  // "CVPB"
+
+bool readFile(const std::string& path, std::string& out) {
+    std::ifstream in(path, std::ios::in | std::ios::binary);
+    if (!in.is_open()) return false;
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// 64-bit FNV-1a; only used to name cache files, not for security.
+uint64_t fnv1a(const std::string& data,
+               uint64_t hash = 1469598103934665603ull) {
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+std::string glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? std::string((const char*)s) : std::string();
+}
+
+// Queues the compile; with parallel compile enabled this returns before
+// the driver has finished, so no status is queried here.
+GLuint compileStage(GLenum type, const std::string& source) {
+    GLuint shader = glCreateShader(type);
+    const char* src = source.c_str();
+    glShaderSource(shader, 1, &src, NULL);
+    glCompileShader(shader);
+    return shader;
+}
+
+void printStageLog(GLuint shader, const std::string& path) {
+    GLint ok = GL_FALSE, logLength = 0;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &ok);
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+    if (!ok && logLength > 0) {
+        std::vector<char> log(logLength + 1);
+        glGetShaderInfoLog(shader, logLength, NULL, log.data());
+        printf("%s: %s\n", path.c_str(), log.data());
+    }
+}
+
+// Insert `#define NAME` lines right after the #version directive, which
+// has to stay the first statement of the shader.
+std::string injectDefines(const std::string& source,
+                          const std::vector<std::string>& defines) {
+    if (defines.empty()) return source;
+    std::string lines;
+    for (const std::string& d : defines) lines += "#define " + d + "\n";
+    size_t version = source.find("#version");
+    size_t at = version == std::string::npos
+                    ? 0
+                    : source.find('\n', version);
+    if (at == std::string::npos) return source + "\n" + lines;
+    if (version != std::string::npos) ++at;
+    return source.substr(0, at) + lines + source.substr(at);
+}
+
+time_t modifiedTime(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? st.st_mtime : 0;
+}
+
+}  // namespace
+
+ShaderCache::ShaderCache(const std::string& binaryDir,
+                         GLFWwindow* compileContext)
+    : m_binaryDir(binaryDir),
+      m_binariesSupported(false),
+      m_parallel(false),
+      m_builtFromSource(0),
+      m_loadedFromBinary(0),
+      m_compileContext(compileContext),
+      m_stopping(false) {
+    m_driver = glString(GL_VENDOR) + "|" + glString(GL_RENDERER) + "|" +
+               glString(GL_VERSION);
+    if (GLAD_GL_VERSION_4_1 || GLAD_GL_ARB_get_program_binary) {
+        GLint formats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        m_binariesSupported = formats > 0;
+    }
+
+    // Let the driver use as many compiler threads as it likes.
+    m_parallel = parallelCompileSupported();
+    if (GLAD_GL_KHR_parallel_shader_compile)
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFFu);
+    else if (GLAD_GL_ARB_parallel_shader_compile)
+        glMaxShaderCompilerThreadsARB(0xFFFFFFFFu);
+    if (!m_parallel && m_compileContext != nullptr)
+        m_worker = std::thread(&ShaderCache::workerLoop, this);
+}
+
+ShaderCache::~ShaderCache() {
+    if (m_worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        m_worker.join();
+    }
+    for (auto& entry : m_builds) {
+        Build* b = entry.second;
+        if (b->vs) glDeleteShader(b->vs);
+        if (b->fs) glDeleteShader(b->fs);
+        if (b->program) glDeleteProgram(b->program);
+        delete b;
+    }
+    for (auto& entry : m_shaders) delete entry.second.shader;
+    for (TextureShader* shader : m_retired) delete shader;
+}
+
+bool ShaderCache::parallelCompileSupported() {
+    return GLAD_GL_KHR_parallel_shader_compile ||
+           GLAD_GL_ARB_parallel_shader_compile;
+}
+
+const char* ShaderCache::asyncMode() const {
+    if (m_parallel) return "parallel";
+    return m_worker.joinable() ? "worker" : "sync";
+}
+
+std::string ShaderCache::keyOf(const std::string& vertexPath,
+                               const std::string& fragmentPath,
+                               const std::vector<std::string>& defines) {
+    std::string key = vertexPath + "|" + fragmentPath;
+    for (const std::string& d : defines) key += "|" + d;
+    return key;
+}
+
+TextureShader* ShaderCache::get(const std::string& vertexPath,
+                                const std::string& fragmentPath,
+                                const std::vector<std::string>& defines) {
+    TextureShader* shader = request(vertexPath, fragmentPath, defines);
+    if (shader != nullptr) return shader;
+
+    const std::string key = keyOf(vertexPath, fragmentPath, defines);
+    auto it = m_builds.find(key);
+    if (it == m_builds.end()) return nullptr;  // failed to build
+    Build* b = it->second;
+    if (!m_parallel) {
+        // The link status query in finalize() blocks on its own in the
+        // parallel case; the worker has to be waited for.
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [&] { return b->done; });
+    }
+    m_builds.erase(it);
+    finalize(b);
+
+    auto done = m_shaders.find(key);
+    return done != m_shaders.end() && m_failed.count(key) == 0
+               ? done->second.shader
+               : nullptr;
+}
+
+TextureShader* ShaderCache::request(const std::string& vertexPath,
+                                    const std::string& fragmentPath,
+                                    const std::vector<std::string>& defines) {
+    const std::string key = keyOf(vertexPath, fragmentPath, defines);
+    const time_t vertexTime = modifiedTime(vertexPath);
+    const time_t fragmentTime = modifiedTime(fragmentPath);
+    auto current = [&](const std::map<std::string, Entry>& entries) {
+        auto it = entries.find(key);
+        return it != entries.end() && it->second.vertexTime == vertexTime &&
+               it->second.fragmentTime == fragmentTime;
+    };
+
+    if (current(m_shaders)) return m_shaders[key].shader;
+    // Failed builds are retried only once a source changes again.
+    if (m_builds.count(key) != 0 || current(m_failed)) return nullptr;
+    if (!start(key, vertexPath, fragmentPath, defines, vertexTime,
+               fragmentTime))
+        return nullptr;
+    // Binary loads and synchronous builds are installed right away.
+    return current(m_shaders) ? m_shaders[key].shader : nullptr;
+}
+
+void ShaderCache::poll() {
+    for (auto it = m_builds.begin(); it != m_builds.end();) {
+        Build* b = it->second;
+        bool complete = false;
+        if (m_parallel) {
+            GLint status = GL_FALSE;
+            glGetProgramiv(b->program, GL_COMPLETION_STATUS_KHR, &status);
+            complete = status == GL_TRUE;
+        } else {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            complete = b->done;
+        }
+        if (!complete) {
+            ++it;
+            continue;
+        }
+        it = m_builds.erase(it);
+        finalize(b);
+    }
+}
+
+bool ShaderCache::building(const std::string& vertexPath,
+                           const std::string& fragmentPath,
+                           const std::vector<std::string>& defines) const {
+    return m_builds.count(keyOf(vertexPath, fragmentPath, defines)) != 0;
+}
+
+bool ShaderCache::start(const std::string& key,
+                        const std::string& vertexPath,
+                        const std::string& fragmentPath,
+                        const std::vector<std::string>& defines,
+                        time_t vertexTime, time_t fragmentTime) {
+    Build* b = new Build();
+    b->key = key;
+    b->vertexPath = vertexPath;
+    b->fragmentPath = fragmentPath;
+    b->vertexTime = vertexTime;
+    b->fragmentTime = fragmentTime;
+    b->label = vertexPath + " + " + fragmentPath;
+    for (const std::string& d : defines) b->label += " " + d;
+    if (!readFile(vertexPath, b->vertexSource) ||
+        !readFile(fragmentPath, b->fragmentSource)) {
+        printf("ShaderCache: cannot read %s / %s\n", vertexPath.c_str(),
+               fragmentPath.c_str());
+        install(b, 0, false);
+        return false;
+    }
+
+    b->fragmentSource = injectDefines(b->fragmentSource, defines);
+
+    // Any change to the driver, either source or the defines produces a
+    // new file name.
+    uint64_t hash = fnv1a(m_driver);
+    hash = fnv1a(std::string(1, '\0') + b->vertexSource, hash);
+    hash = fnv1a(std::string(1, '\0') + b->fragmentSource, hash);
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx.glbin", (unsigned long long)hash);
+    b->file = m_binaryDir + "/" + name;
+
+    GLuint program = m_binariesSupported ? loadBinary(b->file) : 0;
+    if (program != 0) {
+        install(b, program, true);
+    } else if (m_parallel) {
+        beginLink(*b);
+        m_builds[key] = b;
+    } else if (m_worker.joinable()) {
+        m_builds[key] = b;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_jobs.push_back(b);
+        }
+        m_wake.notify_one();
+    } else {
+        beginLink(*b);
+        install(b, finishLink(*b), false);
+    }
+    return true;
+}
+
+// Completes a build taken out of m_builds.
+void ShaderCache::finalize(Build* build) {
+    // The worker has already checked the link on its own context.
+    GLuint program = m_parallel ? finishLink(*build) : build->program;
+    install(build, program, false);
+}
+
+// Takes ownership of `build`; `program` is 0 if it failed.
+void ShaderCache::install(Build* build, GLuint program, bool fromBinary) {
+    Entry entry;
+    entry.vertexTime = build->vertexTime;
+    entry.fragmentTime = build->fragmentTime;
+    if (program == 0) {
+        m_failed[build->key] = entry;
+        delete build;
+        return;
+    }
+    if (fromBinary) {
+        ++m_loadedFromBinary;
+    } else {
+        ++m_builtFromSource;
+        if (m_binariesSupported) saveBinary(program, build->file);
+    }
+
+    // A rebuild replaces the entry; the old shader may still be attached,
+    // so it is only deleted with the cache.
+    auto old = m_shaders.find(build->key);
+    if (old != m_shaders.end()) m_retired.push_back(old->second.shader);
+    entry.shader = new TextureShader(program, true);
+    m_shaders[build->key] = entry;
+    m_failed.erase(build->key);
+    delete build;
+}
+
+void ShaderCache::beginLink(Build& build) {
+    printf("Compiling program : %s\n", build.label.c_str());
+    build.vs = compileStage(GL_VERTEX_SHADER, build.vertexSource);
+    build.fs = compileStage(GL_FRAGMENT_SHADER, build.fragmentSource);
+
+    build.program = glCreateProgram();
+    if (m_binariesSupported)
+        glProgramParameteri(build.program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+                            GL_TRUE);
+    glAttachShader(build.program, build.vs);
+    glAttachShader(build.program, build.fs);
+    glLinkProgram(build.program);
+}
+
+// Blocks until the link has finished unless GL_COMPLETION_STATUS said so.
+GLuint ShaderCache::finishLink(Build& build) {
+    GLint ok = GL_FALSE, logLength = 0;
+    glGetProgramiv(build.program, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        printStageLog(build.vs, build.vertexPath);
+        printStageLog(build.fs, build.fragmentPath);
+    }
+    glDetachShader(build.program, build.vs);
+    glDetachShader(build.program, build.fs);
+    glDeleteShader(build.vs);
+    glDeleteShader(build.fs);
+    build.vs = build.fs = 0;
+
+    GLuint program = build.program;
+    build.program = 0;
+    if (!ok) {
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &logLength);
+        std::vector<char> log(logLength + 1, '\0');
+        if (logLength > 0)
+            glGetProgramInfoLog(program, logLength, NULL, log.data());
+        printf("Linking %s failed: %s\n", build.label.c_str(), log.data());
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+// Builds jobs on the shared compile context. Program objects are shared
+// between the contexts; glFinish makes the finished program visible to the
+// main one before it is handed over.
+void ShaderCache::workerLoop() {
+    glfwMakeContextCurrent(m_compileContext);
+    for (;;) {
+        Build* b = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stopping || !m_jobs.empty(); });
+            if (m_stopping) break;
+            b = m_jobs.front();
+            m_jobs.pop_front();
+        }
+        beginLink(*b);
+        GLuint program = finishLink(*b);
+        glFinish();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            b->program = program;
+            b->done = true;
+        }
+        m_done.notify_all();
+    }
+    glfwMakeContextCurrent(NULL);
+}
+
+// File layout: magic, binary format, byte count, then the blob.
+GLuint ShaderCache::loadBinary(const std::string& file) {
+    FILE* f = fopen(file.c_str(), "rb");
+    if (!f) return 0;
+    uint32_t header[3] = {0, 0, 0};
+    std::vector<char> blob;
+    bool ok = fread(header, sizeof(header), 1, f) == 1 &&
+              header[0] == kBinaryMagic && header[2] > 0;
+    if (ok) {
+        blob.resize(header[2]);
+        ok = fread(blob.data(), 1, blob.size(), f) == blob.size();
+    }
+    fclose(f);
+    if (!ok) return 0;
+
+    GLuint program = glCreateProgram();
+    glProgramBinary(program, (GLenum)header[1], blob.data(),
+                    (GLsizei)blob.size());
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        // Stale or rejected (e.g. driver update with the same strings).
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+void ShaderCache::saveBinary(GLuint program, const std::string& file) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<char> blob(length);
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &length, &format, blob.data());
+
+    mkdir(m_binaryDir.c_str(), 0755);  // fails harmlessly if it exists
+    FILE* f = fopen(file.c_str(), "wb");
+    if (!f) return;
+    uint32_t header[3] = {kBinaryMagic, (uint32_t)format, (uint32_t)length};
+    fwrite(header, sizeof(header), 1, f);
+    fwrite(blob.data(), 1, (size_t)length, f);
+    fclose(f);
+}
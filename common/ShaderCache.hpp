@@ -0,0 +1,158 @@
+/*
+ * ShaderCache.hpp
+ *
+ * Owns one linked TextureShader per (vertex, fragment) source pair, so
+ * switching filters is a pointer swap instead of a recompile. Linked
+ * programs are also written to disk with glGetProgramBinary, keyed by a
+ * hash of the driver identification and both sources; later launches load
+ * the binary and only fall back to compiling when the driver or a shader
+ * changed.
+ *
+ * Compiles can run in the background so a filter switch never stalls a
+ * frame: with GL_KHR/ARB_parallel_shader_compile the driver builds on its
+ * own threads and the cache polls GL_COMPLETION_STATUS; without it a
+ * worker thread builds on a hidden context shared with the main one.
+ * Sources edited on disk are rebuilt the next time they are requested.
+ *
+ * A pair can also be requested with a list of #defines, which are inserted
+ * after the fragment shader's #version line; each distinct list is its own
+ * program (used for the uber-shader permutations).
+ */
+#ifndef SHADERCACHE_HPP
+#define SHADERCACHE_HPP
+
+#include <condition_variable>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "TextureShader.hpp"
+
+struct GLFWwindow;
+
+//!  ShaderCache.
+/*!
+ Needs a current GL context for its whole lifetime. Shaders handed out by
+ get() and request() stay owned by the cache (including ones replaced by a
+ rebuild, which may still be attached somewhere): attach them with
+ Object::setShader(shader, false).
+ */
+class ShaderCache {
+public:
+    //! Constructor
+    /*! Program binaries are stored under `binaryDir` (created on demand).
+        `compileContext` is an optional hidden window sharing objects with
+        the current context; it is only used when the driver cannot compile
+        in parallel, and must outlive the cache. */
+    explicit ShaderCache(const std::string& binaryDir = "shader_cache",
+                         GLFWwindow* compileContext = nullptr);
+    //! Destructor
+    /*! Stops the worker and deletes every cached shader and its program. */
+    ~ShaderCache();
+
+    //! get
+    /*! Shader for the given source pair (and fragment #defines), built (or
+        loaded from disk) on first use; blocks until it is linked. Returns
+        nullptr if the program fails to build. */
+    TextureShader* get(const std::string& vertexPath,
+                       const std::string& fragmentPath,
+                       const std::vector<std::string>& defines = {});
+
+    //! request
+    /*! Non-blocking get(): returns the shader if an up-to-date one is
+        linked, otherwise starts building it (unless a build is already
+        running) and returns nullptr. Call again after poll() to pick it
+        up. */
+    TextureShader* request(const std::string& vertexPath,
+                           const std::string& fragmentPath,
+                           const std::vector<std::string>& defines = {});
+
+    //! poll
+    /*! Finish background builds that have completed. Cheap; call once per
+        frame. */
+    void poll();
+
+    //! building
+    /*! True while a build of the pair is in flight. */
+    bool building(const std::string& vertexPath,
+                  const std::string& fragmentPath,
+                  const std::vector<std::string>& defines = {}) const;
+
+    //! pending
+    /*! Builds currently in flight. */
+    int pending() const { return (int)m_builds.size(); }
+
+    //! asyncMode
+    /*! "parallel", "worker" or "sync": how builds are kept off the frame. */
+    const char* asyncMode() const;
+
+    //! parallelCompileSupported
+    /*! True if the current context can compile in the background itself,
+        in which case no compile context is needed. */
+    static bool parallelCompileSupported();
+
+    //! builtFromSource
+    /*! Programs compiled and linked from GLSL. */
+    int builtFromSource() const { return m_builtFromSource; }
+    //! loadedFromBinary
+    /*! Programs restored from an on-disk program binary. */
+    int loadedFromBinary() const { return m_loadedFromBinary; }
+
+private:
+    // One program being built; owned by m_builds until installed.
+    struct Build {
+        std::string key;
+        std::string vertexPath, vertexSource;
+        std::string fragmentPath, fragmentSource;  // defines inserted
+        std::string label;                         // for log messages
+        std::string file;  // binary cache file
+        time_t vertexTime = 0, fragmentTime = 0;
+        GLuint vs = 0, fs = 0, program = 0;
+        bool done = false;  // set by the worker, guarded by m_mutex
+    };
+    struct Entry {
+        TextureShader* shader = nullptr;
+        time_t vertexTime = 0, fragmentTime = 0;
+    };
+
+    static std::string keyOf(const std::string& vertexPath,
+                             const std::string& fragmentPath,
+                             const std::vector<std::string>& defines);
+    bool start(const std::string& key, const std::string& vertexPath,
+               const std::string& fragmentPath,
+               const std::vector<std::string>& defines, time_t vertexTime,
+               time_t fragmentTime);
+    void finalize(Build* build);
+    void install(Build* build, GLuint program, bool fromBinary);
+    void beginLink(Build& build);
+    GLuint finishLink(Build& build);
+    GLuint loadBinary(const std::string& file);
+    void saveBinary(GLuint program, const std::string& file);
+    void workerLoop();
+
+    std::map<std::string, Entry> m_shaders;
+    std::map<std::string, Build*> m_builds;
+    std::map<std::string, Entry> m_failed;  // stamps of sources that failed
+    std::vector<TextureShader*> m_retired;  // replaced by a rebuild
+    std::string m_binaryDir;
+    std::string m_driver;  // vendor/renderer/version, part of the key
+    bool m_binariesSupported;
+    bool m_parallel;
+    int m_builtFromSource;
+    int m_loadedFromBinary;
+
+    // Shared-context worker, used only without parallel compile.
+    GLFWwindow* m_compileContext;
+    std::thread m_worker;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;  // jobs queued or stopping
+    std::condition_variable m_done;  // a job finished
+    std::deque<Build*> m_jobs;
+    bool m_stopping;
+};
+
+#endif
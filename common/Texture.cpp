@@ -1,179 +1,317 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include <glad/gl.h>
-#include <GLFW/glfw3.h>
-
-#include "Texture.hpp"
-
-Texture::Texture() : m_textureID(0) {}
-
-Texture::Texture(std::string filename) {
-    if (filename.find("dds") != std::string::npos || filename.find("DDS") != std::string::npos)
-        m_textureID = loadDDS(filename.c_str());
-    else
-        m_textureID = loadBMP_custom(filename.c_str());
-}
-
-Texture::Texture(int w, int h) {
-    glGenTextures(1, &m_textureID);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-}
-
-Texture::Texture(unsigned char* data, int width, int height, bool bgrFormat) {
-    glGenTextures(1, &m_textureID);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
-    GLenum inputFormat = bgrFormat ? GL_BGR : GL_RGB;
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, inputFormat, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-}
-
-Texture::~Texture() {
-    if (m_textureID)
-        glDeleteTextures(1, &m_textureID);
-}
-
-void Texture::bindTexture() {
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, m_textureID);
-}
-
-GLuint Texture::getTextureID() {
-    return m_textureID;
-}
-
-GLuint Texture::loadBMP_custom(const char* imagepath) {
-    printf("Reading image %s\n", imagepath);
-
-    unsigned char header[54];
-    unsigned int dataPos;
-    unsigned int imageSize;
-    unsigned int width, height;
-    unsigned char* data;
-
-    FILE* file = fopen(imagepath, "rb");
-    if (!file) {
-        printf("%s could not be opened.\n", imagepath);
-        return 0;
-    }
-
-    if (fread(header, 1, 54, file) != 54) {
-        printf("Not a correct BMP file\n");
-        return 0;
-    }
-    if (header[0] != 'B' || header[1] != 'M') {
-        printf("Not a correct BMP file\n");
-        return 0;
-    }
-    if (*(int*)&(header[0x1E]) != 0 || *(int*)&(header[0x1C]) != 24) {
-        printf("Not a 24bpp BMP file\n");
-        return 0;
-    }
-
-    dataPos = *(int*)&(header[0x0A]);
-    imageSize = *(int*)&(header[0x22]);
-    width = *(int*)&(header[0x12]);
-    height = *(int*)&(header[0x16]);
-
-    if (imageSize == 0) imageSize = width * height * 3;
-    if (dataPos == 0) dataPos = 54;
-
-    data = new unsigned char[imageSize];
-    fread(data, 1, imageSize, file);
-    fclose(file);
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
-    delete[] data;
-
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glGenerateMipmap(GL_TEXTURE_2D);
-
-    return textureID;
-}
-
-#define FOURCC_DXT1 0x31545844
-#define FOURCC_DXT3 0x33545844
-#define FOURCC_DXT5 0x35545844
-
-GLuint Texture::loadDDS(const char* imagepath) {
-    unsigned char header[124];
-    FILE* fp = fopen(imagepath, "rb");
-    if (fp == NULL) {
-        printf("%s could not be opened.\n", imagepath);
-        return 0;
-    }
-
-    char filecode[4];
-    fread(filecode, 1, 4, fp);
-    if (strncmp(filecode, "DDS ", 4) != 0) {
-        fclose(fp);
-        return 0;
-    }
-
-    fread(&header, 124, 1, fp);
-
-    unsigned int height = *(unsigned int*)&(header[8]);
-    unsigned int width = *(unsigned int*)&(header[12]);
-    unsigned int linearSize = *(unsigned int*)&(header[16]);
-    unsigned int mipMapCount = *(unsigned int*)&(header[24]);
-    unsigned int fourCC = *(unsigned int*)&(header[80]);
-
-    unsigned int bufsize = mipMapCount > 1 ? linearSize * 2 : linearSize;
-    unsigned char* buffer = (unsigned char*)malloc(bufsize);
-    fread(buffer, 1, bufsize, fp);
-    fclose(fp);
-
-    unsigned int format;
-    switch (fourCC) {
-        case FOURCC_DXT1: format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
-        case FOURCC_DXT3: format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
-        case FOURCC_DXT5: format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
-        default:
-            free(buffer);
-            return 0;
-    }
-
-    GLuint textureID;
-    glGenTextures(1, &textureID);
-    glBindTexture(GL_TEXTURE_2D, textureID);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-
-    unsigned int blockSize = (format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
-    unsigned int offset = 0;
-
-    for (unsigned int level = 0; level < mipMapCount && (width || height); ++level) {
-        unsigned int size = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
-        glCompressedTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, size, buffer + offset);
-        offset += size;
-        width /= 2;
-        height /= 2;
-        if (width < 1) width = 1;
-        if (height < 1) height = 1;
-    }
-
-    free(buffer);
-    return textureID;
-}
-void Texture::update(unsigned char* data, int width, int height, bool bgrFormat) {
-   
-	 glBindTexture(GL_TEXTURE_2D, m_textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, bgrFormat ? GL_BGR : GL_RGB, GL_UNSIGNED_BYTE, data);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);				
-}
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glad/gl.h>
+#include <GLFW/glfw3.h>
+
+#include "Texture.hpp"
+
+Texture::Texture() : m_textureID(0) {}
+
+Texture::Texture(std::string filename) {
+    if (filename.find("dds") != std::string::npos || filename.find("DDS") != std::string::npos)
+        m_textureID = loadDDS(filename.c_str());
+    else
+        m_textureID = loadBMP_custom(filename.c_str());
+}
+
+Texture::Texture(int w, int h) {
+    glGenTextures(1, &m_textureID);
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, w, h, 0, GL_RGB, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+}
+
+// Render target: empty GL_R8, GL_RGBA8 or GL_RGBA16F storage for a
+// framebuffer to draw into. Clamped, so filters sampling neighbours do not
+// wrap at the borders.
+Texture::Texture(int w, int h, GLenum internalFormat) : m_textureID(0) {
+    allocateStorage(w, h, internalFormat == GL_R8 ? 1 : 4, internalFormat);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+Texture::Texture(unsigned char* data, int width, int height, bool bgrFormat) {
+    glGenTextures(1, &m_textureID);
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+    GLenum inputFormat = bgrFormat ? GL_BGR : GL_RGB;
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, inputFormat, GL_UNSIGNED_BYTE, data);
+    glGenerateMipmap(GL_TEXTURE_2D);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+}
+
+Texture::~Texture() {
+    for (int i = 0; i < kUploadSlots; ++i) {
+        if (m_fence[i]) glDeleteSync(m_fence[i]);
+    }
+    if (m_pbo[0]) glDeleteBuffers(kUploadSlots, m_pbo);
+    if (m_textureID)
+        glDeleteTextures(1, &m_textureID);
+}
+
+void Texture::bindTexture() {
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+}
+
+GLuint Texture::getTextureID() {
+    return m_textureID;
+}
+
+GLuint Texture::loadBMP_custom(const char* imagepath) {
+    printf("Reading image %s\n", imagepath);
+
+    unsigned char header[54];
+    unsigned int dataPos;
+    unsigned int imageSize;
+    unsigned int width, height;
+    unsigned char* data;
+
+    FILE* file = fopen(imagepath, "rb");
+    if (!file) {
+        printf("%s could not be opened.\n", imagepath);
+        return 0;
+    }
+
+    if (fread(header, 1, 54, file) != 54) {
+        printf("Not a correct BMP file\n");
+        return 0;
+    }
+    if (header[0] != 'B' || header[1] != 'M') {
+        printf("Not a correct BMP file\n");
+        return 0;
+    }
+    if (*(int*)&(header[0x1E]) != 0 || *(int*)&(header[0x1C]) != 24) {
+        printf("Not a 24bpp BMP file\n");
+        return 0;
+    }
+
+    dataPos = *(int*)&(header[0x0A]);
+    imageSize = *(int*)&(header[0x22]);
+    width = *(int*)&(header[0x12]);
+    height = *(int*)&(header[0x16]);
+
+    if (imageSize == 0) imageSize = width * height * 3;
+    if (dataPos == 0) dataPos = 54;
+
+    data = new unsigned char[imageSize];
+    fread(data, 1, imageSize, file);
+    fclose(file);
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_BGR, GL_UNSIGNED_BYTE, data);
+    delete[] data;
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    return textureID;
+}
+
+#define FOURCC_DXT1 0x31545844
+#define FOURCC_DXT3 0x33545844
+#define FOURCC_DXT5 0x35545844
+
+GLuint Texture::loadDDS(const char* imagepath) {
+    unsigned char header[124];
+    FILE* fp = fopen(imagepath, "rb");
+    if (fp == NULL) {
+        printf("%s could not be opened.\n", imagepath);
+        return 0;
+    }
+
+    char filecode[4];
+    fread(filecode, 1, 4, fp);
+    if (strncmp(filecode, "DDS ", 4) != 0) {
+        fclose(fp);
+        return 0;
+    }
+
+    fread(&header, 124, 1, fp);
+
+    unsigned int height = *(unsigned int*)&(header[8]);
+    unsigned int width = *(unsigned int*)&(header[12]);
+    unsigned int linearSize = *(unsigned int*)&(header[16]);
+    unsigned int mipMapCount = *(unsigned int*)&(header[24]);
+    unsigned int fourCC = *(unsigned int*)&(header[80]);
+
+    unsigned int bufsize = mipMapCount > 1 ? linearSize * 2 : linearSize;
+    unsigned char* buffer = (unsigned char*)malloc(bufsize);
+    fread(buffer, 1, bufsize, fp);
+    fclose(fp);
+
+    unsigned int format;
+    switch (fourCC) {
+        case FOURCC_DXT1: format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+        case FOURCC_DXT3: format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT; break;
+        case FOURCC_DXT5: format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        default:
+            free(buffer);
+            return 0;
+    }
+
+    GLuint textureID;
+    glGenTextures(1, &textureID);
+    glBindTexture(GL_TEXTURE_2D, textureID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    unsigned int blockSize = (format == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT) ? 8 : 16;
+    unsigned int offset = 0;
+
+    for (unsigned int level = 0; level < mipMapCount && (width || height); ++level) {
+        unsigned int size = ((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+        glCompressedTexImage2D(GL_TEXTURE_2D, level, format, width, height, 0, size, buffer + offset);
+        offset += size;
+        width /= 2;
+        height /= 2;
+        if (width < 1) width = 1;
+        if (height < 1) height = 1;
+    }
+
+    free(buffer);
+    return textureID;
+}
+// Client pixel layout of a frame with `channels` channels (1, 3 or 4).
+static GLenum uploadFormat(int channels, bool bgrFormat) {
+    if (channels == 1) return GL_RED;
+    if (channels == 4) return bgrFormat ? GL_BGRA : GL_RGBA;
+    return bgrFormat ? GL_BGR : GL_RGB;
+}
+
+// (Re)create the texture storage for streaming. Immutable storage cannot
+// be respecified, so a new texture name is generated when it is available.
+void Texture::allocateStorage(int width, int height, int channels,
+                              GLenum internalFormat) {
+    if (internalFormat == 0)
+        internalFormat =
+            channels == 1 ? GL_R8 : (channels == 4 ? GL_RGBA8 : GL_RGB8);
+    bool immutable = GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_storage;
+    if (immutable || m_textureID == 0) {
+        if (m_textureID) glDeleteTextures(1, &m_textureID);
+        glGenTextures(1, &m_textureID);
+    }
+    glBindTexture(GL_TEXTURE_2D, m_textureID);
+    if (immutable) {
+        glTexStorage2D(GL_TEXTURE_2D, 1, internalFormat, width, height);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0,
+                     uploadFormat(channels, true), GL_UNSIGNED_BYTE, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    // Gray frames live in the red channel; replicate it on sampling.
+    GLint swizzle[4] = {GL_RED, GL_GREEN, GL_BLUE, GL_ALPHA};
+    if (channels == 1) {
+        swizzle[1] = GL_RED;
+        swizzle[2] = GL_RED;
+        swizzle[3] = GL_ONE;
+    }
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+
+    m_width = width;
+    m_height = height;
+    m_channels = channels;
+}
+
+void Texture::update(unsigned char* data, int width, int height, bool bgrFormat,
+                     int channels, size_t rowStride) {
+    if (width != m_width || height != m_height || channels != m_channels)
+        allocateStorage(width, height, channels);
+    else
+        glBindTexture(GL_TEXTURE_2D, m_textureID);
+
+    // Describe the caller's row layout to GL. A stride that is a whole
+    // number of pixels maps onto GL_UNPACK_ROW_LENGTH; padding that only
+    // rounds the row up to 2/4/8 bytes maps onto GL_UNPACK_ALIGNMENT.
+    const size_t rowBytes = (size_t)width * channels;
+    if (rowStride == 0) rowStride = rowBytes;
+    GLint rowLength = 0, alignment = 0;
+    if (rowStride % channels == 0) {
+        rowLength = (GLint)(rowStride / channels);
+        alignment = 1;
+    } else {
+        for (GLint a = 8; a >= 1; a /= 2) {
+            if ((rowBytes + a - 1) / a * a == rowStride) {
+                alignment = a;
+                break;
+            }
+        }
+    }
+    // Neither fits (odd padding): repack rows into the buffer below.
+    const bool repack = alignment == 0;
+    const size_t packedStride = repack ? rowBytes : rowStride;
+    const size_t bytes = packedStride * (height - 1) + rowBytes;
+
+    if (m_pbo[0] == 0) glGenBuffers(kUploadSlots, m_pbo);
+    const int slot = m_pboIndex;
+    m_pboIndex = (m_pboIndex + 1) % kUploadSlots;
+
+    // The slot was last used kUploadSlots frames ago; wait until the GPU
+    // has finished copying out of it before writing again. If the fence
+    // does not signal (timeout or error), the mapping below synchronises
+    // instead.
+    bool idle = true;
+    if (m_fence[slot]) {
+        GLenum status = glClientWaitSync(
+            m_fence[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+        idle = status == GL_ALREADY_SIGNALED ||
+               status == GL_CONDITION_SATISFIED;
+        glDeleteSync(m_fence[slot]);
+        m_fence[slot] = nullptr;
+    }
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[slot]);
+    if (bytes > m_pboBytes) {
+        // Grow the whole ring at once so every slot fits the new frame.
+        for (int i = 0; i < kUploadSlots; ++i) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[i]);
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, bytes, nullptr,
+                         GL_STREAM_DRAW);
+        }
+        m_pboBytes = bytes;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[slot]);
+    }
+    // Once the fence above has signalled the GPU is done with this buffer,
+    // so the mapping does not need to synchronise.
+    GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT;
+    if (idle) access |= GL_MAP_UNSYNCHRONIZED_BIT;
+    unsigned char* dst = (unsigned char*)glMapBufferRange(
+        GL_PIXEL_UNPACK_BUFFER, 0, bytes, access);
+    if (dst) {
+        if (repack) {
+            for (int y = 0; y < height; ++y)
+                memcpy(dst + y * rowBytes, data + y * rowStride, rowBytes);
+            rowLength = 0;
+            alignment = 1;
+        } else {
+            memcpy(dst, data, bytes);
+        }
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, rowLength);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height,
+                        uploadFormat(channels, bgrFormat), GL_UNSIGNED_BYTE,
+                        (const void*)0);
+        m_fence[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        // Restore the defaults other uploads rely on.
+        glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
@@ -1,36 +1,70 @@
-/*
- * Texture.hpp
- *
- *  Class for representing a texture.
- *  by Stefanie Zollmann
- *
- */
-#ifndef TEXTURE_HPP
-#define TEXTURE_HPP
-// Include standard headers
-#include <stdio.h>
-#include <stdlib.h>
-#include <string>
-#include <vector>
-
-class Texture {
-public:
-    Texture();
-    Texture(std::string filename);
-    Texture(int w, int h);
-    Texture(unsigned char* data, int width, int height, bool bgrFormat = true);
-    ~Texture();
-
-    void bindTexture();
-    GLuint getTextureID();
-    void update(unsigned char* data, int width, int height, bool bgrFormat = true);
-
-
-private:
-    GLuint loadBMP_custom(const char* imagepath);
-    GLuint loadDDS(const char* imagepath);
-
-    GLuint m_textureID;
-};
-
+/*
+ * Texture.hpp
+ *
+ *  Class for representing a texture.
+ *  by Stefanie Zollmann
+ *
+ */
+#ifndef TEXTURE_HPP
+#define TEXTURE_HPP
+// Include standard headers
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+class Texture {
+public:
+    Texture();
+    Texture(std::string filename);
+    Texture(int w, int h);
+    // Render target with GL_R8 (gray, swizzled like 1-channel uploads),
+    // GL_RGBA8 or GL_RGBA16F storage; see RenderTargetPool.
+    Texture(int w, int h, GLenum internalFormat);
+    Texture(unsigned char* data, int width, int height, bool bgrFormat = true);
+    ~Texture();
+
+    void bindTexture();
+    GLuint getTextureID();
+    // Size of the storage allocated by update() or the render target
+    // constructor; 0 before that.
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
+    // channels: 3 = BGR/RGB and 4 = BGRA/RGBA (per bgrFormat), 1 = gray,
+    // stored as GL_R8 and swizzled to (r, r, r, 1) so shaders see gray in
+    // every channel. The format follows whatever is passed in, so it can
+    // change per frame.
+    // Streams through a ring of pixel-unpack buffers into storage that is
+    // only reallocated when the size or channel count changes; the call
+    // returns once the frame is copied into a buffer, not when the GPU has
+    // consumed it.
+    // Rows are expected top-down (shaders flip V when sampling). rowStride
+    // is the distance between rows in bytes (0 = tightly packed), so ROIs
+    // and padded/aligned buffers upload without being repacked.
+    void update(unsigned char* data, int width, int height, bool bgrFormat = true,
+                int channels = 3, size_t rowStride = 0);
+
+
+private:
+    GLuint loadBMP_custom(const char* imagepath);
+    GLuint loadDDS(const char* imagepath);
+
+    // internalFormat overrides the format derived from channels (render
+    // targets with float storage).
+    void allocateStorage(int width, int height, int channels,
+                         GLenum internalFormat = 0);
+
+    GLuint m_textureID;
+    int m_channels = 3;
+
+    // Streaming upload state
+    static const int kUploadSlots = 3;
+    int m_width = 0;        // size of the current storage; 0 = none yet
+    int m_height = 0;
+    GLuint m_pbo[kUploadSlots] = {0, 0, 0};
+    GLsync m_fence[kUploadSlots] = {nullptr, nullptr, nullptr};
+    size_t m_pboBytes = 0;  // size every ring buffer is allocated with
+    int m_pboIndex = 0;
+};
+
 #endif
\ No newline at end of file
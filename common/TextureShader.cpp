@@ -7,13 +7,19 @@ TextureShader::TextureShader() {}
 TextureShader::TextureShader(std::string vertexshaderName,
                              std::string fragmentshaderName)
     : Shader(vertexshaderName, fragmentshaderName) {
-    m_TextureID = glGetUniformLocation(programID, "myTextureSampler");
+    m_TextureID = uniformLocation("myTextureSampler");
 }
 
 // version of constructor that assumes that vertex and fragment shader have same
 // name
 TextureShader::TextureShader(std::string shaderName) : Shader(shaderName) {
-    m_TextureID = glGetUniformLocation(programID, "myTextureSampler");
+    m_TextureID = uniformLocation("myTextureSampler");
+}
+
+// version of constructor that wraps an already linked program
+TextureShader::TextureShader(GLuint program, bool ownsProgram) {
+    adoptProgram(program, ownsProgram);
+    m_TextureID = uniformLocation("myTextureSampler");
 }
 
 TextureShader::~TextureShader() {
@@ -26,7 +32,7 @@ TextureShader::~TextureShader() {
 void TextureShader::setTexture(Texture* texture) {
     m_texture = texture;
     // Get a handle for our "myTextureSampler" uniform
-    m_TextureID = glGetUniformLocation(programID, "myTextureSampler");
+    m_TextureID = uniformLocation("myTextureSampler");
 }
 
 void TextureShader::bind() {
@@ -0,0 +1,228 @@
+#include "filters/CannyEngine.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace Filters {
+
+namespace {
+
+// Direction classification from cv::Canny: tan(22.5 deg) in Q15.
+const int kCannyShift = 15;
+const int kTan22 =
+    (int)(0.4142135623730950488016887242097 * (1 << kCannyShift) + 0.5);
+
+// Pixel classes in the edge map until hysteresis has finished.
+const uint8_t kNone = 0;
+const uint8_t kWeak = 1;
+const uint8_t kEdge = 255;
+
+// Rows per band. Enough bands to balance load across the pool, but tall
+// enough that the recomputed halo rows stay a small fraction of the work.
+int bandHeight(int rows) {
+    int target = std::max(1, cv::getNumThreads()) * 4;
+    return std::max(16, (rows + target - 1) / target);
+}
+
+}  // namespace
+
+CannyEngine::CannyEngine() : m_low(0), m_high(0), m_rounds(0) {}
+
+// Sobel + L1 magnitude + non-maximum suppression for the band's rows,
+// streaming through three rolling rows. Writes kNone/kWeak/kEdge and seeds
+// the hysteresis stack with the strong pixels.
+void CannyEngine::suppress(const cv::Mat& gray, cv::Mat& edges, Band& band) {
+    const int W = gray.cols, H = gray.rows;
+    const int padded = W + 2;
+
+    // Gradient and magnitude of row `y` into rolling slot (y + 3) % 3. Rows
+    // outside the image have zero magnitude, as in cv::Canny.
+    auto gradientRow = [&](int y) {
+        int slot = (y + 3) % 3;
+        int32_t* mag = band.mag.data() + slot * padded;
+        if (y < 0 || y >= H) {
+            std::fill(mag, mag + padded, 0);
+            return;
+        }
+        const uint8_t* above = gray.ptr<uint8_t>(std::max(y - 1, 0));
+        const uint8_t* row = gray.ptr<uint8_t>(y);
+        const uint8_t* below = gray.ptr<uint8_t>(std::min(y + 1, H - 1));
+        int16_t* smooth = band.smooth.data();
+        int16_t* diff = band.diff.data();
+        // Vertical passes; index x + 1 holds column x, borders replicate.
+        for (int x = 0; x < W; ++x) {
+            smooth[x + 1] = (int16_t)(above[x] + 2 * row[x] + below[x]);
+            diff[x + 1] = (int16_t)(below[x] - above[x]);
+        }
+        smooth[0] = smooth[1];
+        smooth[W + 1] = smooth[W];
+        diff[0] = diff[1];
+        diff[W + 1] = diff[W];
+        // Horizontal passes; plain loops over int16 that the compiler
+        // vectorises.
+        int16_t* dx = band.dx.data() + slot * W;
+        int16_t* dy = band.dy.data() + slot * W;
+        for (int x = 0; x < W; ++x) {
+            dx[x] = (int16_t)(smooth[x + 2] - smooth[x]);
+            dy[x] = (int16_t)(diff[x] + 2 * diff[x + 1] + diff[x + 2]);
+        }
+        mag[0] = 0;
+        mag[W + 1] = 0;
+        for (int x = 0; x < W; ++x)
+            mag[x + 1] = std::abs(dx[x]) + std::abs(dy[x]);
+    };
+
+    band.stack.clear();
+    gradientRow(band.r0 - 1);
+    gradientRow(band.r0);
+    for (int y = band.r0; y < band.r1; ++y) {
+        gradientRow(y + 1);
+        const int32_t* prev = band.mag.data() + ((y + 2) % 3) * padded + 1;
+        const int32_t* cur = band.mag.data() + ((y + 3) % 3) * padded + 1;
+        const int32_t* next = band.mag.data() + ((y + 4) % 3) * padded + 1;
+        const int16_t* dx = band.dx.data() + ((y + 3) % 3) * W;
+        const int16_t* dy = band.dy.data() + ((y + 3) % 3) * W;
+        uint8_t* e = edges.ptr<uint8_t>(y);
+
+        for (int x = 0; x < W; ++x) {
+            int m = cur[x];
+            e[x] = kNone;
+            if (m <= m_low) continue;
+
+            int xs = dx[x], ys = dy[x];
+            int ax = std::abs(xs);
+            int ay = std::abs(ys) << kCannyShift;
+            int tg22x = ax * kTan22;
+            bool peak;
+            if (ay < tg22x) {
+                peak = m > cur[x - 1] && m >= cur[x + 1];
+            } else {
+                int tg67x = tg22x + (ax << (kCannyShift + 1));
+                if (ay > tg67x) {
+                    peak = m > prev[x] && m >= next[x];
+                } else {
+                    int s = (xs ^ ys) < 0 ? -1 : 1;
+                    peak = m > prev[x - s] && m > next[x + s];
+                }
+            }
+            if (!peak) continue;
+            if (m > m_high) {
+                e[x] = kEdge;
+                band.stack.push_back(y * W + x);
+            } else {
+                e[x] = kWeak;
+            }
+        }
+    }
+}
+
+// Grow edges from the stack through weak pixels of this band. Neighbours
+// in the rows just outside the band are queued for the adjacent band.
+void CannyEngine::follow(cv::Mat& edges, Band& band, int parity) {
+    const int W = edges.cols, H = edges.rows;
+    std::vector<int32_t>& up = band.out[parity][0];
+    std::vector<int32_t>& down = band.out[parity][1];
+    up.clear();
+    down.clear();
+
+    while (!band.stack.empty()) {
+        int32_t idx = band.stack.back();
+        band.stack.pop_back();
+        int y = idx / W, x = idx - y * W;
+        for (int yy = std::max(y - 1, 0); yy <= std::min(y + 1, H - 1);
+             ++yy) {
+            uint8_t* row = edges.ptr<uint8_t>(yy);
+            for (int xx = std::max(x - 1, 0); xx <= std::min(x + 1, W - 1);
+                 ++xx) {
+                if (yy < band.r0) {
+                    up.push_back(yy * W + xx);
+                } else if (yy >= band.r1) {
+                    down.push_back(yy * W + xx);
+                } else if (row[xx] == kWeak) {
+                    row[xx] = kEdge;
+                    band.stack.push_back(yy * W + xx);
+                }
+            }
+        }
+    }
+}
+
+void CannyEngine::detect(const cv::Mat& gray, cv::Mat& edges,
+                         double lowThreshold, double highThreshold) {
+    CV_Assert(gray.type() == CV_8UC1 && gray.data != edges.data);
+    edges.create(gray.size(), CV_8UC1);
+    const int W = gray.cols, H = gray.rows;
+    m_rounds = 0;
+    if (W == 0 || H == 0) return;
+
+    if (lowThreshold > highThreshold) std::swap(lowThreshold, highThreshold);
+    m_low = (int)std::floor(lowThreshold);
+    m_high = (int)std::floor(highThreshold);
+
+    // (Re)partition; the scratch vectors keep their capacity otherwise.
+    const int bh = bandHeight(H);
+    const int count = (H + bh - 1) / bh;
+    m_bands.resize(count);
+    for (int i = 0; i < count; ++i) {
+        Band& b = m_bands[i];
+        b.r0 = i * bh;
+        b.r1 = std::min(H, b.r0 + bh);
+        b.smooth.resize(W + 2);
+        b.diff.resize(W + 2);
+        b.dx.resize(3 * W);
+        b.dy.resize(3 * W);
+        b.mag.resize(3 * (W + 2));
+    }
+
+    // Suppression and band-local hysteresis.
+    cv::parallel_for_(cv::Range(0, count), [&](const cv::Range& r) {
+        for (int i = r.start; i < r.end; ++i) {
+            suppress(gray, edges, m_bands[i]);
+            follow(edges, m_bands[i], 0);
+        }
+    });
+
+    // Halo exchange: each band picks up what its neighbours queued for it
+    // last round. Bands only ever write their own rows.
+    int parity = 0;
+    for (;;) {
+        bool pending = false;
+        for (const Band& b : m_bands)
+            pending = pending || !b.out[parity][0].empty() ||
+                      !b.out[parity][1].empty();
+        if (!pending) break;
+
+        cv::parallel_for_(cv::Range(0, count), [&](const cv::Range& r) {
+            for (int i = r.start; i < r.end; ++i) {
+                Band& b = m_bands[i];
+                b.stack.clear();
+                auto take = [&](const std::vector<int32_t>& inbox) {
+                    for (int32_t idx : inbox) {
+                        uint8_t& v = edges.data[(idx / W) * edges.step +
+                                                idx % W];
+                        if (v == kWeak) {
+                            v = kEdge;
+                            b.stack.push_back(idx);
+                        }
+                    }
+                };
+                if (i > 0) take(m_bands[i - 1].out[parity][1]);
+                if (i + 1 < count) take(m_bands[i + 1].out[parity][0]);
+                follow(edges, b, parity ^ 1);
+            }
+        });
+        parity ^= 1;
+        ++m_rounds;
+    }
+
+    // Weak pixels never reached from a strong one are not edges.
+    cv::parallel_for_(cv::Range(0, count), [&](const cv::Range& r) {
+        for (int y = m_bands[r.start].r0; y < m_bands[r.end - 1].r1; ++y) {
+            uint8_t* e = edges.ptr<uint8_t>(y);
+            for (int x = 0; x < W; ++x) e[x] = e[x] == kEdge ? kEdge : kNone;
+        }
+    });
+}
+
+}  // namespace Filters
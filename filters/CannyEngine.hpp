@@ -0,0 +1,70 @@
+/*
+ * CannyEngine.hpp
+ *
+ * Tile-parallel Canny edge detector producing a single-channel edge map.
+ * The image is cut into bands of rows; each band streams Sobel, magnitude
+ * and non-maximum suppression through a three-row rolling window
+ * (recomputing the one-row halo above and below instead of sharing it),
+ * then runs hysteresis locally. Edges that cross a band boundary are
+ * handed to the neighbouring band and the exchange repeats until no band
+ * has anything left to pass on. Results match cv::Canny with the L1
+ * gradient and a 3x3 aperture.
+ */
+#ifndef CANNYENGINE_HPP
+#define CANNYENGINE_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+namespace Filters {
+
+//!  CannyEngine.
+/*!
+ Keeps per-band scratch buffers between calls, so after the first frame
+ at a given resolution detection does no heap allocation. One instance
+ must not be used from several threads at once.
+ */
+class CannyEngine {
+public:
+    CannyEngine();
+
+    //! detect
+    /*! Write the edges of 8-bit single-channel `gray` into `edges` (same
+        size, CV_8UC1, 0 or 255; must not alias `gray`). Gradients with
+        L1 magnitude above `highThreshold` seed edges, those above
+        `lowThreshold` extend them. */
+    void detect(const cv::Mat& gray, cv::Mat& edges, double lowThreshold,
+                double highThreshold);
+
+    //! bandCount
+    /*! Number of row bands used by the last detect() call. */
+    int bandCount() const { return (int)m_bands.size(); }
+
+    //! exchangeRounds
+    /*! Halo exchange rounds hysteresis needed in the last detect() call. */
+    int exchangeRounds() const { return m_rounds; }
+
+private:
+    struct Band {
+        int r0, r1;  // rows [r0, r1)
+        std::vector<int16_t> smooth, diff;  // vertical Sobel passes
+        std::vector<int16_t> dx, dy;        // 3 rolling rows each
+        std::vector<int32_t> mag;           // 3 rolling rows, zero-padded
+        std::vector<int32_t> stack;         // hysteresis work list
+        std::vector<int32_t> out[2][2];     // [round parity][up, down]
+    };
+
+    void suppress(const cv::Mat& gray, cv::Mat& edges, Band& band);
+    void follow(cv::Mat& edges, Band& band, int parity);
+
+    std::vector<Band> m_bands;
+    int m_low;
+    int m_high;
+    int m_rounds;
+};
+
+}  // namespace Filters
+
+#endif
@@ -1,63 +1,74 @@
 #include "Filters.hpp"
 
+#include "filters/GrayscaleKernel.hpp"
+#include "filters/PixelateKernel.hpp"
+
 namespace Filters {
 
-void applyGrayscaleCPU(cv::Mat& frame) {
-    if (frame.empty()) return;
-    // Convert to grayscale then back to BGR to keep 3 channels (texture code
-    // expects BGR data in this project).
-    cv::Mat gray;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-        cv::cvtColor(gray, frame, cv::COLOR_GRAY2BGR);
-    } else if (frame.channels() == 4) {
+// Convert 8-bit BGR or BGRA input to a pooled single-channel luma buffer
+// (`tag` names the buffer, so callers can keep the result); 8-bit gray is
+// returned as is. Other formats are rejected.
+static const cv::Mat& lumaOf(const cv::Mat& frame, FramePool& pool,
+                             const char* tag = "filters.luma") {
+    const int type = frame.type();
+    if (type == CV_8UC1) return frame;
+    if (type != CV_8UC3 && type != CV_8UC4)
+        CV_Error(cv::Error::StsUnsupportedFormat,
+                 "CPU filters expect 8-bit gray, BGR or BGRA frames");
+    cv::Mat& gray = pool.acquire(tag, frame.size(), CV_8UC1);
+    if (type == CV_8UC3) {
+        // Fused single pass, one byte written per pixel.
+        lumaBGR(frame.data, frame.step, gray.data, gray.step, frame.cols,
+                frame.rows);
+    } else {
         cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
-        cv::cvtColor(gray, frame, cv::COLOR_GRAY2BGR);
-    } else if (frame.channels() == 1) {
-        // Already single channel
-        cv::cvtColor(frame, frame, cv::COLOR_GRAY2BGR);
     }
+    return gray;
 }
 
-void applyCannyCPU(cv::Mat& frame, double threshold1, double threshold2) {
+void applyGrayscaleCPU(cv::Mat& frame, FramePool& pool) {
     if (frame.empty()) return;
-    cv::Mat gray;
-    if (frame.channels() == 3) {
-        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
-    } else if (frame.channels() == 4) {
-        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
-    } else {
-        gray = frame.clone();
-    }
+    // Gray needs one channel; the texture upload shows it as gray.
+    frame = lumaOf(frame, pool, "gray.out");
+}
 
-    cv::Mat edges;
-    cv::Canny(gray, edges, threshold1, threshold2);
+void applyCannyCPU(cv::Mat& frame, FramePool& pool, CannyEngine& engine,
+                   double threshold1, double threshold2) {
+    if (frame.empty()) return;
+    const cv::Mat& gray = lumaOf(frame, pool);
 
-    // Convert edges -> BGR so the rest of the pipeline (which expects 3
-    // channels) continues to work.
-    cv::Mat edgesBGR;
-    cv::cvtColor(edges, edgesBGR, cv::COLOR_GRAY2BGR);
-    frame = edgesBGR;
+    cv::Mat& edges = pool.acquire("canny.edges", frame.size(), CV_8UC1);
+    engine.detect(gray, edges, threshold1, threshold2);
+    frame = edges;
 }
 
-void applyPixelateCPU(cv::Mat& frame, int pixelSize) {
+void applyPixelateCPU(cv::Mat& frame, FramePool& pool, int pixelSize) {
     if (frame.empty() || pixelSize <= 1) return;
 
-    cv::Mat temp = frame.clone();
+    // Blocks do not overlap, so every mean can be read straight from the
+    // input; no clone is needed.
+    cv::Mat& out = pool.acquire("pixelate.out", frame.size(), frame.type());
+    if (frame.depth() == CV_8U && frame.channels() <= 4) {
+        // Block sums in one streaming pass, then a row-replicating fill.
+        cv::Mat& sums = pool.acquire(
+            "pixelate.sums",
+            pixelateScratchSize(frame.size(), frame.channels(), pixelSize),
+            CV_32SC1);
+        pixelateBlocks(frame, out, pixelSize, sums);
+        frame = out;
+        return;
+    }
+
+    // Other depths: per-block mean and fill.
     for (int y = 0; y < frame.rows; y += pixelSize) {
         for (int x = 0; x < frame.cols; x += pixelSize) {
-            // Define the region of interest
             int width = std::min(pixelSize, frame.cols - x);
             int height = std::min(pixelSize, frame.rows - y);
             cv::Rect roi(x, y, width, height);
-
-            // Compute the average color in the ROI
-            cv::Scalar avgColor = cv::mean(temp(roi));
-
-            // Fill the ROI with the average color
-            frame(roi).setTo(avgColor);
+            out(roi).setTo(cv::mean(frame(roi)));
         }
     }
+    frame = out;
 }
 
 std::string gpuFragmentPathGrayscale() { return "gpu_grayscale.frag"; }
@@ -66,4 +77,34 @@ std::string gpuFragmentPathEdge() { return "gpu_edge.frag"; }
 
 std::string gpuFragmentPathPixelate() { return "gpu_pixelate.frag"; }
 
+std::string gpuFragmentPathPixelateReduce() {
+    return "gpu_pixelate_reduce.frag";
+}
+
+std::string gpuFragmentPathCanny(const std::string& stage) {
+    return "gpu_canny_" + stage + ".frag";
+}
+
+std::vector<std::string> GPUPermutation::defines() const {
+    std::vector<std::string> out;
+    if (filter == "gray") out.push_back("FILTER_GRAY");
+    if (filter == "edge") out.push_back("FILTER_EDGE");
+    if (filter == "pixelate") out.push_back("FILTER_PIXELATE");
+    if (transform) out.push_back("TRANSFORM");
+    return out;
+}
+
+std::string GPUPermutation::name() const {
+    return transform ? filter + "+transform" : filter;
+}
+
+std::string gpuFragmentPathUber() { return "gpu_uber.frag"; }
+
+std::vector<GPUPermutation> gpuUberPermutations() {
+    std::vector<GPUPermutation> out;
+    for (const char* filter : {"none", "gray", "edge", "pixelate"})
+        for (bool transform : {false, true}) out.push_back({filter, transform});
+    return out;
+}
+
 }  // namespace Filters
@@ -10,21 +10,55 @@
 
 #include <opencv2/opencv.hpp>
 #include <string>
+#include <vector>
+
+#include "common/FramePool.hpp"
+#include "filters/CannyEngine.hpp"
 
 namespace Filters {
 
-// CPU implementations (operate in-place on frames)
-// - expect BGR 3-channel or BGRA 4-channel images coming from OpenCV
-void applyGrayscaleCPU(cv::Mat& frame);
-void applyCannyCPU(cv::Mat& frame, double threshold1 = 50.0,
-                   double threshold2 = 150.0);
-void applyPixelateCPU(cv::Mat& frame, int pixelSize = 10);
+// CPU implementations
+// - expect 8-bit BGR 3-channel, BGRA 4-channel or 1-channel gray images
+//   (grayscale and Canny throw cv::Exception for anything else)
+// - grayscale and Canny return 1-channel frames, pixelate keeps the
+//   input's channel count
+// - never write into the input: the result goes to a buffer from `pool`
+//   and `frame` is rebound to it, so read-only (zero-copy) input is fine
+// - Canny keeps its per-band scratch in the caller's `engine`, which (like
+//   the pool) one thread at a time may use
+void applyGrayscaleCPU(cv::Mat& frame, FramePool& pool);
+void applyCannyCPU(cv::Mat& frame, FramePool& pool, CannyEngine& engine,
+                   double threshold1 = 50.0, double threshold2 = 150.0);
+void applyPixelateCPU(cv::Mat& frame, FramePool& pool, int pixelSize = 10);
 
 // GPU helpers: return path to fragment shader files that implement the
 // corresponding GPU version of the filter (these are GLSL placeholders).
 std::string gpuFragmentPathGrayscale();
 std::string gpuFragmentPathEdge();
 std::string gpuFragmentPathPixelate();
+// Pixelate runs as two passes on the GPU: a reduction to one texel per
+// block (exact means) and the nearest-neighbour expansion above.
+std::string gpuFragmentPathPixelateReduce();
+// The GPU Canny (GPUCanny.hpp) runs one fragment shader per stage:
+// "gradient", "nms", "hysteresis" and "finalize".
+std::string gpuFragmentPathCanny(const std::string& stage);
+
+// GPU uber-shader: the filters and the UV transform of gpu_transform.frag
+// in one fragment shader behind #defines, so a filter and the transform
+// run fused in a single pass with no intermediate render target (pixelate
+// keeps its reduction pass in front and fuses the expansion). Each
+// permutation is compiled on first use.
+struct GPUPermutation {
+    std::string filter;  // "none", "gray", "edge" or "pixelate"
+    bool transform;      // apply the UV transform before filtering
+    // #defines selecting this permutation in gpuFragmentPathUber()
+    std::vector<std::string> defines() const;
+    // e.g. "edge+transform"
+    std::string name() const;
+};
+std::string gpuFragmentPathUber();
+// Every permutation of the uber-shader, for benchmark sweeps.
+std::vector<GPUPermutation> gpuUberPermutations();
 
 }  // namespace Filters
 
@@ -0,0 +1,210 @@
+#include "GPUCanny.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "filters/Filters.hpp"
+
+namespace Filters {
+
+namespace {
+
+const char* kVertex = "fullscreenPass.vert";
+const char* kGradient = "canny.gradient";
+const char* kNms = "canny.nms";
+const char* kHysteresis = "canny.hysteresis";
+const char* kFinalize = "canny.finalize";
+
+// Profiler sections may be absent.
+void begin(GPUProfiler* profiler, const char* name) {
+    if (profiler != nullptr) profiler->begin(name);
+}
+
+void end(GPUProfiler* profiler, const char* name) {
+    if (profiler != nullptr) profiler->end(name);
+}
+
+}  // namespace
+
+GPUCanny::GPUCanny(ShaderCache& cache, int maxPasses)
+    : m_cache(cache),
+      m_gradient(nullptr),
+      m_nms(nullptr),
+      m_hysteresis(nullptr),
+      m_probe(nullptr),
+      m_finalize(nullptr),
+      m_failed(false),
+      m_low(50),
+      m_high(150),
+      m_maxPasses(std::max(0, maxPasses)),
+      m_passes(0),
+      m_converged(true),
+      m_output(nullptr),
+      m_lastProbe(-1) {}
+
+GPUCanny::~GPUCanny() {
+    if (!m_probeQueries.empty())
+        glDeleteQueries((GLsizei)m_probeQueries.size(),
+                        m_probeQueries.data());
+}
+
+void GPUCanny::setThresholds(double lowThreshold, double highThreshold) {
+    if (lowThreshold > highThreshold) std::swap(lowThreshold, highThreshold);
+    m_low = (int)std::floor(lowThreshold);
+    m_high = (int)std::floor(highThreshold);
+}
+
+void GPUCanny::setMaxPasses(int maxPasses) {
+    m_maxPasses = std::max(0, maxPasses);
+}
+
+bool GPUCanny::prepare(bool wait) {
+    struct Program {
+        TextureShader** shader;
+        std::string fragment;
+        std::vector<std::string> defines;
+    };
+    const Program programs[] = {
+        {&m_gradient, gpuFragmentPathCanny("gradient"), {}},
+        {&m_nms, gpuFragmentPathCanny("nms"), {}},
+        {&m_hysteresis, gpuFragmentPathCanny("hysteresis"), {}},
+        {&m_probe, gpuFragmentPathCanny("hysteresis"), {"PROBE"}},
+        {&m_finalize, gpuFragmentPathCanny("finalize"), {}}};
+    bool ready = true;
+    for (const Program& p : programs) {
+        // Asked every time, so edited sources are picked up like for
+        // single-pass filters.
+        *p.shader = wait ? m_cache.get(kVertex, p.fragment, p.defines)
+                         : m_cache.request(kVertex, p.fragment, p.defines);
+        if (*p.shader == nullptr &&
+            (wait || !m_cache.building(kVertex, p.fragment, p.defines)))
+            m_failed = true;
+        ready = ready && *p.shader != nullptr;
+    }
+    if (ready) m_failed = false;
+    return ready;
+}
+
+void GPUCanny::draw(TextureShader* shader, Texture* input,
+                    RenderTarget* target) {
+    glBindFramebuffer(GL_FRAMEBUFFER, target->framebuffer);
+    glViewport(0, 0, target->width, target->height);
+    shader->setTexture(input);
+    shader->bind();
+    // fullscreenPass.vert needs no vertex buffer (see PassChain).
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+}
+
+// Would another hysteresis pass change anything? The probe program only
+// lets pixels that would grow through, so `query` counts zero samples once
+// the edges stopped growing; `scratch` is just somewhere to draw with
+// colour writes off (it must not be `classes`' own target).
+void GPUCanny::probe(Texture* classes, RenderTarget* scratch, GLuint query) {
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glBeginQuery(GL_ANY_SAMPLES_PASSED, query);
+    draw(m_probe, classes, scratch);
+    glEndQuery(GL_ANY_SAMPLES_PASSED);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+}
+
+bool GPUCanny::probeReady(int probe) {
+    GLuint available = 0;
+    glGetQueryObjectuiv(m_probeQueries[probe], GL_QUERY_RESULT_AVAILABLE,
+                        &available);
+    return available != 0;
+}
+
+// Waits for the result unless probeReady() said it is in.
+bool GPUCanny::probeConverged(int probe) {
+    GLuint any = 1;
+    glGetQueryObjectuiv(m_probeQueries[probe], GL_QUERY_RESULT, &any);
+    return any == 0;
+}
+
+RenderTarget* GPUCanny::render(Texture* input, RenderTargetPool& pool,
+                               GPUProfiler* profiler) {
+    const int width = input->getWidth(), height = input->getHeight();
+
+    RenderTarget* gradient = pool.acquire(width, height, GL_RGBA16F);
+    begin(profiler, kGradient);
+    draw(m_gradient, input, gradient);
+    end(profiler, kGradient);
+
+    RenderTarget* classes = pool.acquire(width, height, GL_R8);
+    begin(profiler, kNms);
+    m_nms->setTexture(gradient->texture);
+    m_nms->bind();
+    glUniform2i(m_nms->uniformLocation("thresholds"), m_low, m_high);
+    draw(m_nms, gradient->texture, classes);
+    end(profiler, kNms);
+    pool.release(gradient);
+
+    // Hysteresis ping-pongs between `classes` and `scratch` in batches of
+    // kProbeInterval passes, each followed by a probe of `classes`. A batch
+    // and its probe are conditionally rendered on the previous probe, so
+    // once nothing grows the GPU skips them and `classes` keeps the
+    // converged map (without the result at hand the GPU just runs them,
+    // which changes nothing either). The CPU stops issuing batches at the
+    // cap, or earlier once a probe result already available says so.
+    RenderTarget* scratch = pool.acquire(width, height, GL_R8);
+    int cap = m_maxPasses > 0 ? m_maxPasses : std::max(width, height);
+    cap = (cap + kProbeInterval - 1) / kProbeInterval * kProbeInterval;
+    begin(profiler, kHysteresis);
+    m_passes = 0;
+    m_converged = false;
+    int probes = 0, checked = 0;
+    while (!m_converged && m_passes < cap) {
+        if (probes == (int)m_probeQueries.size()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            m_probeQueries.push_back(query);
+        }
+        if (probes > 0)
+            glBeginConditionalRender(m_probeQueries[probes - 1],
+                                     GL_QUERY_NO_WAIT);
+        for (int i = 0; i < kProbeInterval; i += 2) {
+            draw(m_hysteresis, classes->texture, scratch);
+            draw(m_hysteresis, scratch->texture, classes);
+        }
+        m_passes += kProbeInterval;
+        probe(classes->texture, scratch, m_probeQueries[probes]);
+        if (probes > 0) glEndConditionalRender();
+        ++probes;
+        // Results only become available once the commands are submitted.
+        glFlush();
+        while (!m_converged && checked < probes && probeReady(checked))
+            m_converged = probeConverged(checked++);
+    }
+    m_lastProbe = probes - 1;
+    end(profiler, kHysteresis);
+    pool.release(scratch);
+
+    m_output = pool.acquire(width, height, GL_R8);
+    begin(profiler, kFinalize);
+    draw(m_finalize, classes->texture, m_output);
+    end(profiler, kFinalize);
+    pool.release(classes);
+    return m_output;
+}
+
+void GPUCanny::readback(cv::Mat& edges) {
+    if (m_output == nullptr) return;
+    if (!m_converged && m_lastProbe >= 0)
+        m_converged = probeConverged(m_lastProbe);
+    edges.create(m_output->height, m_output->width, CV_8UC1);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_output->framebuffer);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ROW_LENGTH, (GLint)edges.step);
+    // Target rows are in the frame's top-down order already.
+    glReadPixels(0, 0, edges.cols, edges.rows, GL_RED, GL_UNSIGNED_BYTE,
+                 edges.data);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+}
+
+std::vector<std::string> GPUCanny::timerNames() const {
+    return {kGradient, kNms, kHysteresis, kFinalize};
+}
+
+}  // namespace Filters
@@ -0,0 +1,104 @@
+/*
+ * GPUCanny.hpp
+ *
+ * Canny edge detector on the GPU, as a multi-pass stage of a PassChain:
+ * gradient (luma, Sobel, L1 magnitude), non-maximum suppression with the
+ * double threshold, then hysteresis passes that grow strong edges through
+ * weak pixels (at least three pixels per pass) until nothing changes or a
+ * pass cap is reached, and a pass dropping the weak pixels that were never
+ * reached.
+ * Every step uses the integer arithmetic of Filters::CannyEngine, so a
+ * converged result matches Filters::applyCannyCPU exactly.
+ */
+#ifndef GPUCANNY_HPP
+#define GPUCANNY_HPP
+
+#include <string>
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "common/PassChain.hpp"
+#include "common/ShaderCache.hpp"
+
+namespace Filters {
+
+//!  GPUCanny.
+/*!
+ Programs come from a ShaderCache, which must outlive the stage. Each
+ step is a GPUProfiler section ("canny.gradient", ...). Convergence is
+ checked every few hysteresis passes with an occlusion query that the
+ following passes are conditionally rendered on, so the GPU skips them
+ once the edges stop growing; the CPU never waits for the query.
+ */
+class GPUCanny : public PassStage {
+public:
+    //! Constructor
+    /*! At most `maxPasses` hysteresis passes run per frame; 0 caps them
+        at the larger frame dimension. */
+    explicit GPUCanny(ShaderCache& cache, int maxPasses = 0);
+    //! Destructor
+    /*! Deletes the occlusion queries; needs the GL context. */
+    ~GPUCanny();
+
+    //! setThresholds
+    /*! Same meaning as for Filters::applyCannyCPU (swapped if reversed). */
+    void setThresholds(double lowThreshold, double highThreshold);
+    //! setMaxPasses
+    void setMaxPasses(int maxPasses);
+
+    bool prepare(bool wait) override;
+    bool failed() const override { return m_failed; }
+    RenderTarget* render(Texture* input, RenderTargetPool& pool,
+                         GPUProfiler* profiler) override;
+    std::vector<std::string> timerNames() const override;
+
+    //! readback
+    /*! Copy the edges of the last render() into `edges` (CV_8UC1, 0 or
+        255). Waits for the GPU, and for the last convergence check (see
+        converged()); only valid until the target is reused by the next
+        frame's passes. */
+    void readback(cv::Mat& edges);
+
+    //! hysteresisPasses
+    /*! Hysteresis passes the last render() issued; the GPU skips those
+        after the edges stopped growing. */
+    int hysteresisPasses() const { return m_passes; }
+    //! converged
+    /*! False if the last render() stopped at the pass cap with weak
+        pixels still growing. Only settled by readback(): until then it is
+        also false while the last check is still in flight. */
+    bool converged() const { return m_converged; }
+
+private:
+    // Hysteresis passes between two convergence checks; even, so every
+    // batch of ping-pong passes ends in the same class map.
+    static const int kProbeInterval = 4;
+
+    void draw(TextureShader* shader, Texture* input, RenderTarget* target);
+    void probe(Texture* classes, RenderTarget* scratch, GLuint query);
+    bool probeReady(int probe);
+    bool probeConverged(int probe);
+
+    ShaderCache& m_cache;
+    TextureShader* m_gradient;
+    TextureShader* m_nms;
+    TextureShader* m_hysteresis;
+    TextureShader* m_probe;  // hysteresis with PROBE defined
+    TextureShader* m_finalize;
+    bool m_failed;
+
+    int m_low, m_high;
+    int m_maxPasses;
+    int m_passes;
+    bool m_converged;
+    RenderTarget* m_output;  // result of the last render()
+
+    // One occlusion query per check of a frame, grown as needed.
+    std::vector<GLuint> m_probeQueries;
+    int m_lastProbe;  // last check of the last render(), -1 if none
+};
+
+}  // namespace Filters
+
+#endif
@@ -0,0 +1,237 @@
+#include "filters/GrayscaleKernel.hpp"
+
+#include <cstdint>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define GRAYSCALE_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace Filters {
+
+// Weights sum to 256, so the 16-bit accumulator never overflows:
+// 255 * 256 + 128 = 65408.
+static const int kWeightB = 29;
+static const int kWeightG = 150;
+static const int kWeightR = 77;
+
+// Row kernels are templated on the number of output channels: 3 writes
+// the luma back to B, G and R, 1 writes a plain luma row.
+template <int DstCn>
+static void grayscaleRowScalar(const unsigned char* src, unsigned char* dst,
+                               int width) {
+    for (int x = 0; x < width; ++x) {
+        unsigned b = src[3 * x], g = src[3 * x + 1], r = src[3 * x + 2];
+        unsigned char y =
+            (unsigned char)((kWeightB * b + kWeightG * g + kWeightR * r +
+                             128) >> 8);
+        for (int c = 0; c < DstCn; ++c) dst[DstCn * x + c] = y;
+    }
+}
+
+#ifdef GRAYSCALE_X86_DISPATCH
+
+// Shuffle masks for 16 BGR pixels spread over three 16-byte registers
+// (a = bytes 0..15, b = 16..31, c = 32..47). -1 zeroes the lane so the three
+// partial gathers can be OR-ed together.
+#define GRAY_DEINTERLEAVE_MASKS                                               \
+    const __m128i bA = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i bB = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i bC = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, \
+                                     -1, 1, 4, 7, 10, 13);                    \
+    const __m128i gA = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i gB = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15,  \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i gC = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, \
+                                     -1, 2, 5, 8, 11, 14);                    \
+    const __m128i rA = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i rB = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, \
+                                     -1, -1, -1, -1, -1);                     \
+    const __m128i rC = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, \
+                                     0, 3, 6, 9, 12, 15);                     \
+    const __m128i y0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4,  \
+                                     4, 4, 5);                                \
+    const __m128i y1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9,  \
+                                     9, 10, 10);                              \
+    const __m128i y2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, \
+                                     14, 14, 14, 15, 15, 15);
+
+template <int DstCn>
+__attribute__((target("sse4.1"))) static void grayscaleRowSSE41(
+    const unsigned char* src, unsigned char* dst, int width) {
+    GRAY_DEINTERLEAVE_MASKS
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i wB = _mm_set1_epi16(kWeightB);
+    const __m128i wG = _mm_set1_epi16(kWeightG);
+    const __m128i wR = _mm_set1_epi16(kWeightR);
+    const __m128i round = _mm_set1_epi16(128);
+
+    int x = 0;
+    for (; x + 16 <= width; x += 16) {
+        const unsigned char* s = src + 3 * x;
+        __m128i a = _mm_loadu_si128((const __m128i*)s);
+        __m128i b = _mm_loadu_si128((const __m128i*)(s + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(s + 32));
+
+        __m128i B = _mm_or_si128(
+            _mm_or_si128(_mm_shuffle_epi8(a, bA), _mm_shuffle_epi8(b, bB)),
+            _mm_shuffle_epi8(c, bC));
+        __m128i G = _mm_or_si128(
+            _mm_or_si128(_mm_shuffle_epi8(a, gA), _mm_shuffle_epi8(b, gB)),
+            _mm_shuffle_epi8(c, gC));
+        __m128i R = _mm_or_si128(
+            _mm_or_si128(_mm_shuffle_epi8(a, rA), _mm_shuffle_epi8(b, rB)),
+            _mm_shuffle_epi8(c, rC));
+
+        __m128i lo = _mm_add_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(B, zero), wB),
+                          _mm_mullo_epi16(_mm_unpacklo_epi8(G, zero), wG)),
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(R, zero), wR),
+                          round));
+        __m128i hi = _mm_add_epi16(
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(B, zero), wB),
+                          _mm_mullo_epi16(_mm_unpackhi_epi8(G, zero), wG)),
+            _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(R, zero), wR),
+                          round));
+        __m128i Y = _mm_packus_epi16(_mm_srli_epi16(lo, 8),
+                                     _mm_srli_epi16(hi, 8));
+
+        if (DstCn == 1) {
+            _mm_storeu_si128((__m128i*)(dst + x), Y);
+            continue;
+        }
+        unsigned char* d = dst + 3 * x;
+        _mm_storeu_si128((__m128i*)d, _mm_shuffle_epi8(Y, y0));
+        _mm_storeu_si128((__m128i*)(d + 16), _mm_shuffle_epi8(Y, y1));
+        _mm_storeu_si128((__m128i*)(d + 32), _mm_shuffle_epi8(Y, y2));
+    }
+    grayscaleRowScalar<DstCn>(src + 3 * x, dst + DstCn * x, width - x);
+}
+
+template <int DstCn>
+__attribute__((target("avx2"))) static void grayscaleRowAVX2(
+    const unsigned char* src, unsigned char* dst, int width) {
+    GRAY_DEINTERLEAVE_MASKS
+    // pshufb works per 128-bit lane: lane 0 carries pixels 0..15, lane 1
+    // pixels 16..31, so the SSE masks are simply broadcast to both lanes.
+    const __m256i BA = _mm256_broadcastsi128_si256(bA);
+    const __m256i BB = _mm256_broadcastsi128_si256(bB);
+    const __m256i BC = _mm256_broadcastsi128_si256(bC);
+    const __m256i GA = _mm256_broadcastsi128_si256(gA);
+    const __m256i GB = _mm256_broadcastsi128_si256(gB);
+    const __m256i GC = _mm256_broadcastsi128_si256(gC);
+    const __m256i RA = _mm256_broadcastsi128_si256(rA);
+    const __m256i RB = _mm256_broadcastsi128_si256(rB);
+    const __m256i RC = _mm256_broadcastsi128_si256(rC);
+    const __m256i Y0 = _mm256_broadcastsi128_si256(y0);
+    const __m256i Y1 = _mm256_broadcastsi128_si256(y1);
+    const __m256i Y2 = _mm256_broadcastsi128_si256(y2);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i wB = _mm256_set1_epi16(kWeightB);
+    const __m256i wG = _mm256_set1_epi16(kWeightG);
+    const __m256i wR = _mm256_set1_epi16(kWeightR);
+    const __m256i round = _mm256_set1_epi16(128);
+
+    int x = 0;
+    for (; x + 32 <= width; x += 32) {
+        const unsigned char* s = src + 3 * x;
+        __m256i a = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)s)),
+            _mm_loadu_si128((const __m128i*)(s + 48)), 1);
+        __m256i b = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(s + 16))),
+            _mm_loadu_si128((const __m128i*)(s + 64)), 1);
+        __m256i c = _mm256_inserti128_si256(
+            _mm256_castsi128_si256(_mm_loadu_si128((const __m128i*)(s + 32))),
+            _mm_loadu_si128((const __m128i*)(s + 80)), 1);
+
+        __m256i B = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, BA),
+                                                    _mm256_shuffle_epi8(b, BB)),
+                                    _mm256_shuffle_epi8(c, BC));
+        __m256i G = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, GA),
+                                                    _mm256_shuffle_epi8(b, GB)),
+                                    _mm256_shuffle_epi8(c, GC));
+        __m256i R = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, RA),
+                                                    _mm256_shuffle_epi8(b, RB)),
+                                    _mm256_shuffle_epi8(c, RC));
+
+        __m256i lo = _mm256_add_epi16(
+            _mm256_add_epi16(
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(B, zero), wB),
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(G, zero), wG)),
+            _mm256_add_epi16(
+                _mm256_mullo_epi16(_mm256_unpacklo_epi8(R, zero), wR), round));
+        __m256i hi = _mm256_add_epi16(
+            _mm256_add_epi16(
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(B, zero), wB),
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(G, zero), wG)),
+            _mm256_add_epi16(
+                _mm256_mullo_epi16(_mm256_unpackhi_epi8(R, zero), wR), round));
+        // unpack/pack are lane-local too, so Y keeps the per-lane layout.
+        __m256i Y = _mm256_packus_epi16(_mm256_srli_epi16(lo, 8),
+                                        _mm256_srli_epi16(hi, 8));
+        if (DstCn == 1) {
+            _mm_storeu_si128((__m128i*)(dst + x), _mm256_castsi256_si128(Y));
+            _mm_storeu_si128((__m128i*)(dst + x + 16),
+                             _mm256_extracti128_si256(Y, 1));
+            continue;
+        }
+
+        __m256i o0 = _mm256_shuffle_epi8(Y, Y0);
+        __m256i o1 = _mm256_shuffle_epi8(Y, Y1);
+        __m256i o2 = _mm256_shuffle_epi8(Y, Y2);
+        unsigned char* d = dst + 3 * x;
+        _mm_storeu_si128((__m128i*)d, _mm256_castsi256_si128(o0));
+        _mm_storeu_si128((__m128i*)(d + 16), _mm256_castsi256_si128(o1));
+        _mm_storeu_si128((__m128i*)(d + 32), _mm256_castsi256_si128(o2));
+        _mm_storeu_si128((__m128i*)(d + 48), _mm256_extracti128_si256(o0, 1));
+        _mm_storeu_si128((__m128i*)(d + 64), _mm256_extracti128_si256(o1, 1));
+        _mm_storeu_si128((__m128i*)(d + 80), _mm256_extracti128_si256(o2, 1));
+    }
+    grayscaleRowSSE41<DstCn>(src + 3 * x, dst + DstCn * x, width - x);
+}
+
+#undef GRAY_DEINTERLEAVE_MASKS
+
+#endif  // GRAYSCALE_X86_DISPATCH
+
+typedef void (*GrayscaleRowFn)(const unsigned char*, unsigned char*, int);
+
+struct RowKernels {
+    const char* name;
+    GrayscaleRowFn replicate;  // BGR -> BGR
+    GrayscaleRowFn luma;       // BGR -> 1 channel
+};
+
+static RowKernels selectRowKernels() {
+#ifdef GRAYSCALE_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return {"avx2", grayscaleRowAVX2<3>, grayscaleRowAVX2<1>};
+    if (__builtin_cpu_supports("sse4.1"))
+        return {"sse4.1", grayscaleRowSSE41<3>, grayscaleRowSSE41<1>};
+#endif
+    return {"scalar", grayscaleRowScalar<3>, grayscaleRowScalar<1>};
+}
+
+static const RowKernels g_kernels = selectRowKernels();
+
+void grayscaleBGR(const unsigned char* src, size_t srcStep, unsigned char* dst,
+                  size_t dstStep, int width, int height) {
+    for (int y = 0; y < height; ++y)
+        g_kernels.replicate(src + y * srcStep, dst + y * dstStep, width);
+}
+
+void lumaBGR(const unsigned char* src, size_t srcStep, unsigned char* dst,
+             size_t dstStep, int width, int height) {
+    for (int y = 0; y < height; ++y)
+        g_kernels.luma(src + y * srcStep, dst + y * dstStep, width);
+}
+
+const char* grayscaleKernelName() { return g_kernels.name; }
+
+}  // namespace Filters
@@ -0,0 +1,33 @@
+/*
+ * GrayscaleKernel.hpp
+ *
+ * Fused single-pass BGR -> gray -> BGR kernel. Reads three channels,
+ * computes integer-weighted luma (77 R + 150 G + 29 B + 128) >> 8 and writes
+ * the value back to all three channels, or once into a single-channel
+ * image. Hand-vectorised for AVX2 and SSE4.1 with runtime dispatch on x86,
+ * scalar everywhere else.
+ */
+#ifndef GRAYSCALEKERNEL_HPP
+#define GRAYSCALEKERNEL_HPP
+
+#include <cstddef>
+
+namespace Filters {
+
+// Process `height` rows of `width` BGR pixels. `src` and `dst` may be the
+// same buffer (in-place); steps are in bytes.
+void grayscaleBGR(const unsigned char* src, size_t srcStep, unsigned char* dst,
+                  size_t dstStep, int width, int height);
+
+// Same luma, written as one byte per pixel. `src` and `dst` must not
+// overlap.
+void lumaBGR(const unsigned char* src, size_t srcStep, unsigned char* dst,
+             size_t dstStep, int width, int height);
+
+// Name of the code path grayscaleBGR() and lumaBGR() dispatch to ("avx2", "sse4.1" or
+// "scalar").
+const char* grayscaleKernelName();
+
+}  // namespace Filters
+
+#endif
@@ -0,0 +1,89 @@
+#include "filters/PixelateKernel.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace Filters {
+
+cv::Size pixelateScratchSize(cv::Size frameSize, int channels,
+                             int blockSize) {
+    int blocksX = (frameSize.width + blockSize - 1) / blockSize;
+    int bands = (frameSize.height + blockSize - 1) / blockSize;
+    return cv::Size(blocksX * channels, bands);
+}
+
+// Reduce + fill one band of rows. CN is a template parameter so the inner
+// channel loop unrolls completely.
+template <int CN>
+static void pixelateBand(const cv::Mat& src, cv::Mat& dst, int blockSize,
+                         int band, int32_t* sums) {
+    const int cols = src.cols;
+    const int blocksX = (cols + blockSize - 1) / blockSize;
+    const int y0 = band * blockSize;
+    const int y1 = std::min(y0 + blockSize, src.rows);
+    const int fullBlocks = cols / blockSize;
+
+    memset(sums, 0, sizeof(int32_t) * blocksX * CN);
+
+    // Pass 1: accumulate per-block channel sums, streaming each row once.
+    for (int y = y0; y < y1; ++y) {
+        const uint8_t* p = src.ptr<uint8_t>(y);
+        int32_t* s = sums;
+        for (int bx = 0; bx < fullBlocks; ++bx, s += CN) {
+            int32_t acc[CN] = {0};
+            for (int i = 0; i < blockSize; ++i, p += CN)
+                for (int c = 0; c < CN; ++c) acc[c] += p[c];
+            for (int c = 0; c < CN; ++c) s[c] += acc[c];
+        }
+        // Partial block at the right edge
+        for (int x = fullBlocks * blockSize; x < cols; ++x, p += CN)
+            for (int c = 0; c < CN; ++c) s[c] += p[c];
+    }
+
+    // Pass 2: write one row of rounded means, then replicate it.
+    uint8_t* first = dst.ptr<uint8_t>(y0);
+    const int rows = y1 - y0;
+    for (int bx = 0; bx < blocksX; ++bx) {
+        int x0 = bx * blockSize;
+        int w = std::min(blockSize, cols - x0);
+        int32_t n = w * rows;
+        uint8_t mean[CN];
+        for (int c = 0; c < CN; ++c)
+            mean[c] = (uint8_t)((sums[bx * CN + c] + n / 2) / n);
+        uint8_t* d = first + x0 * CN;
+        for (int i = 0; i < w; ++i, d += CN)
+            for (int c = 0; c < CN; ++c) d[c] = mean[c];
+    }
+    const size_t rowBytes = (size_t)cols * CN;
+    for (int y = y0 + 1; y < y1; ++y)
+        memcpy(dst.ptr<uint8_t>(y), first, rowBytes);
+}
+
+template <int CN>
+static void pixelateParallel(const cv::Mat& src, cv::Mat& dst, int blockSize,
+                             cv::Mat& sums) {
+    const int bands = (src.rows + blockSize - 1) / blockSize;
+    // One scratch row per band, so bands never share state.
+    cv::parallel_for_(cv::Range(0, bands), [&](const cv::Range& range) {
+        for (int band = range.start; band < range.end; ++band)
+            pixelateBand<CN>(src, dst, blockSize, band,
+                             sums.ptr<int32_t>(band));
+    });
+}
+
+void pixelateBlocks(const cv::Mat& src, cv::Mat& dst, int blockSize,
+                    cv::Mat& sums) {
+    CV_Assert(src.depth() == CV_8U && src.data != dst.data);
+    CV_Assert(sums.type() == CV_32SC1 &&
+              sums.size() == pixelateScratchSize(src.size(), src.channels(),
+                                                 blockSize));
+    switch (src.channels()) {
+        case 1: pixelateParallel<1>(src, dst, blockSize, sums); break;
+        case 2: pixelateParallel<2>(src, dst, blockSize, sums); break;
+        case 3: pixelateParallel<3>(src, dst, blockSize, sums); break;
+        case 4: pixelateParallel<4>(src, dst, blockSize, sums); break;
+        default: CV_Error(cv::Error::StsBadArg, "pixelate: 1-4 channels");
+    }
+}
+
+}  // namespace Filters
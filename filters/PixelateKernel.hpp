@@ -0,0 +1,29 @@
+/*
+ * PixelateKernel.hpp
+ *
+ * Streaming block-reduction pixelate. Each band of `blockSize` rows is
+ * reduced in one pass that accumulates per-block channel sums row by row,
+ * then filled by writing one row of block means and copying it down the
+ * band. Bands are independent and run in parallel across cores. Cost per
+ * pixel is constant regardless of block size.
+ */
+#ifndef PIXELATEKERNEL_HPP
+#define PIXELATEKERNEL_HPP
+
+#include <opencv2/opencv.hpp>
+
+namespace Filters {
+
+// Pixelate 8-bit `src` (1-4 channels) into `dst` (same size and type,
+// must not alias `src`). `sums` is scratch space of at least
+// ceil(rows / blockSize) x (ceil(cols / blockSize) * channels) CV_32S;
+// pass a pooled buffer to avoid allocations.
+void pixelateBlocks(const cv::Mat& src, cv::Mat& dst, int blockSize,
+                    cv::Mat& sums);
+
+// Size of the `sums` scratch buffer pixelateBlocks() needs.
+cv::Size pixelateScratchSize(cv::Size frameSize, int channels, int blockSize);
+
+}  // namespace Filters
+
+#endif
@@ -7,6 +7,14 @@
 ROOT="/Users/albertbz/Library/CloudStorage/OneDrive-Personal/Dokumenter/University/7. semester/Visual Computing/Assignment2"
 mkdir -p "$ROOT/bench-results" "$ROOT/bench-results/plots"
 
+# Frame input, e.g. SOURCE="video:/path/clip.mp4" SOURCE_FPS=0 for an
+# unthrottled, reproducible replay instead of the live camera.
+SOURCE="${SOURCE:-camera:1}"
+SOURCE_FPS="${SOURCE_FPS:--1}"
+# Presentation flags, e.g. PRESENT="--unthrottled" so the swap (and vsync)
+# stays out of the frame times, or PRESENT="--pace-fps 60 --swap-interval 0".
+PRESENT="${PRESENT:-}"
+
 # Frames per run (adjust if you want longer/shorter runs)
 FRAMES=120
 
@@ -37,6 +45,7 @@ for BUILD in build-debug build-release; do
           # execute from Webcam/ so shader relative paths resolve correctly
           (cd "$ROOT/Webcam" && "$BIN" --benchmark --out "../$OUT" \
             --filter "$FILTER" --backend "$BACKEND" --transforms "$TRANSFORMS" \
+            --source "$SOURCE" --loop --source-fps "$SOURCE_FPS" ${=PRESENT} \
             --resolution "$RES" --frames "$FRAMES" \
             --translateU $T_U --translateV $T_V --scale $SCALE --rotation $ROT)
           # brief pause between runs to let system settle
@@ -45,6 +54,48 @@ for BUILD in build-debug build-release; do
       done
     done
   done
+
+  # Compute-shader edge filter, to compare against the fragment version
+  for TRANSFORMS in off gpu; do
+    for RES in 1024x768 2048x1536; do
+      OUT="bench-results/bench_edge_compute_${TRANSFORMS}_${RES}_${BUILD}.csv"
+      echo "Running: $BUILD edge compute $TRANSFORMS $RES -> $OUT"
+      (cd "$ROOT/Webcam" && "$BIN" --benchmark --out "../$OUT" \
+        --filter edge --backend compute --transforms "$TRANSFORMS" \
+        --source "$SOURCE" --loop --source-fps "$SOURCE_FPS" ${=PRESENT} \
+        --resolution "$RES" --frames "$FRAMES" \
+        --translateU $T_U --translateV $T_V --scale $SCALE --rotation $ROT)
+      sleep 0.5
+    done
+  done
+
+  # Multi-pass GPU Canny, the GPU counterpart of the CPU edge filter
+  for TRANSFORMS in off gpu; do
+    for RES in 1024x768 2048x1536; do
+      OUT="bench-results/bench_canny_gpu_${TRANSFORMS}_${RES}_${BUILD}.csv"
+      echo "Running: $BUILD canny gpu $TRANSFORMS $RES -> $OUT"
+      (cd "$ROOT/Webcam" && "$BIN" --benchmark --out "../$OUT" \
+        --filter canny --backend gpu --transforms "$TRANSFORMS" \
+        --source "$SOURCE" --loop --source-fps "$SOURCE_FPS" ${=PRESENT} \
+        --resolution "$RES" --frames "$FRAMES" \
+        --translateU $T_U --translateV $T_V --scale $SCALE --rotation $ROT)
+      sleep 0.5
+    done
+  done
+
+  # Fused uber-shader: one run per permutation the binary reports
+  "$BIN" --list-permutations | while read FILTER TRANSFORMS; do
+    for RES in 1024x768 2048x1536; do
+      OUT="bench-results/bench_${FILTER}_uber_${TRANSFORMS}_${RES}_${BUILD}.csv"
+      echo "Running: $BUILD $FILTER uber $TRANSFORMS $RES -> $OUT"
+      (cd "$ROOT/Webcam" && "$BIN" --benchmark --out "../$OUT" \
+        --filter "$FILTER" --backend uber --transforms "$TRANSFORMS" \
+        --source "$SOURCE" --loop --source-fps "$SOURCE_FPS" ${=PRESENT} \
+        --resolution "$RES" --frames "$FRAMES" \
+        --translateU $T_U --translateV $T_V --scale $SCALE --rotation $ROT)
+      sleep 0.5
+    done
+  done
 done
 
 echo "FULL BENCHMARK COMPLETE"
@@ -3,6 +3,14 @@
 ROOT="/Users/albertbz/Library/CloudStorage/OneDrive-Personal/Dokumenter/University/7. semester/Visual Computing/Assignment2"
 mkdir -p "$ROOT/bench-results" "$ROOT/bench-results/plots"
 
+# Frame input, e.g. SOURCE="video:/path/clip.mp4" SOURCE_FPS=0 for an
+# unthrottled, reproducible replay instead of the live camera.
+SOURCE="${SOURCE:-camera:1}"
+SOURCE_FPS="${SOURCE_FPS:--1}"
+# Presentation flags, e.g. PRESENT="--unthrottled" so the swap (and vsync)
+# stays out of the frame times, or PRESENT="--pace-fps 60 --swap-interval 0".
+PRESENT="${PRESENT:-}"
+
 for BUILD in build-debug build-release; do
   BIN="$ROOT/$BUILD/Webcam"
   if [ ! -x "$BIN" ]; then
@@ -22,6 +30,7 @@ for BUILD in build-debug build-release; do
           echo "Running: $BUILD $FILTER $BACKEND $TRANSFORMS $RES -> $OUT"
           (cd "$ROOT/Webcam" && "$BIN" --benchmark --out "../$OUT" \
             --filter "$FILTER" --backend "$BACKEND" --transforms "$TRANSFORMS" \
+            --source "$SOURCE" --loop --source-fps "$SOURCE_FPS" ${=PRESENT} \
             --resolution "$RES" --frames 120 \
             --translateU 0.12 --translateV -0.08 --scale 1.25 --rotation 15)
           sleep 0.5
@@ -0,0 +1,74 @@
+#include "transforms/RemapCache.hpp"
+
+#include <climits>
+#include <cmath>
+
+#include "transforms/Transforms.hpp"
+
+RemapCache::RemapCache()
+    : m_valid(false), m_hits(0), m_misses(0), m_bypasses(0) {}
+
+double RemapCache::hitRate() const {
+    uint64_t total = m_hits + m_misses;
+    return total == 0 ? 0.0 : (double)m_hits / (double)total;
+}
+
+// Fixed-point form of the coordinates, same encoding as cv::convertMaps
+// with CV_16SC2: integer part in m_xy, the INTER_BITS fractional bits of
+// y and x packed into one index into OpenCV's bilinear weight table.
+void RemapCache::build(const cv::Matx23d& M, cv::Size size) {
+    m_xy.create(size, CV_16SC2);
+    m_weights.create(size, CV_16UC1);
+
+    const double scale = cv::INTER_TAB_SIZE;
+    const int mask = cv::INTER_TAB_SIZE - 1;
+    cv::parallel_for_(cv::Range(0, size.height), [&](const cv::Range& r) {
+        for (int y = r.start; y < r.end; ++y) {
+            short* xy = m_xy.ptr<short>(y);
+            unsigned short* w = m_weights.ptr<unsigned short>(y);
+            // Source position is linear in x: step it instead of
+            // re-evaluating the matrix per pixel.
+            double sx = (M(0, 1) * y + M(0, 2)) * scale;
+            double sy = (M(1, 1) * y + M(1, 2)) * scale;
+            const double dx = M(0, 0) * scale, dy = M(1, 0) * scale;
+            for (int x = 0; x < size.width; ++x, sx += dx, sy += dy) {
+                int fx = cv::saturate_cast<int>(sx);
+                int fy = cv::saturate_cast<int>(sy);
+                xy[2 * x] = cv::saturate_cast<short>(fx >> cv::INTER_BITS);
+                xy[2 * x + 1] =
+                    cv::saturate_cast<short>(fy >> cv::INTER_BITS);
+                w[x] = (unsigned short)((fy & mask) * cv::INTER_TAB_SIZE +
+                                        (fx & mask));
+            }
+        }
+    });
+    m_matrix = M;
+    m_size = size;
+    m_valid = true;
+}
+
+void RemapCache::apply(cv::Mat& frame, FramePool& pool, const cv::Matx23d& M,
+                       bool interactive) {
+    if (frame.empty() || Transforms::isIdentityAffine(M)) return;
+    if (interactive) {
+        ++m_bypasses;
+        Transforms::applyAffineCPU(frame, pool, M);
+        return;
+    }
+
+    bool same = m_valid && m_size == frame.size();
+    for (int i = 0; same && i < 2; ++i)
+        for (int j = 0; same && j < 3; ++j)
+            same = m_matrix(i, j) == M(i, j);
+    if (same) {
+        ++m_hits;
+    } else {
+        ++m_misses;
+        build(M, frame.size());
+    }
+
+    cv::Mat& out = pool.acquire("transform.remap", frame.size(), frame.type());
+    cv::remap(frame, out, m_xy, m_weights, cv::INTER_LINEAR,
+              cv::BORDER_CONSTANT, cv::Scalar(51, 25.5, 25.5));
+    frame = out;
+}
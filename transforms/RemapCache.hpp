@@ -0,0 +1,66 @@
+/*
+ * RemapCache.hpp
+ *
+ * Cached fixed-point remap tables for the CPU transform path. The affine
+ * map is turned into per-pixel integer source coordinates plus bilinear
+ * weight indices (the layout cv::remap consumes natively) once per
+ * parameter/resolution change; while the parameters stay put every frame
+ * is a single table-driven gather with no geometry math.
+ */
+#ifndef REMAPCACHE_HPP
+#define REMAPCACHE_HPP
+
+#include <cstdint>
+
+#include <opencv2/opencv.hpp>
+
+#include "common/FramePool.hpp"
+
+//!  RemapCache.
+/*!
+ Holds the tables for one (matrix, resolution) pair. Not thread-safe; the
+ table build and the gather are parallelised internally.
+ */
+class RemapCache {
+public:
+    RemapCache();
+
+    //! apply
+    /*! Warp `frame` with `M` (output pixel -> source pixel, as passed to
+        Transforms::applyAffineCPU) into a pooled buffer and rebind
+        `frame` to it. With `interactive` set (parameters changing every
+        frame, e.g. while dragging) the tables are neither built nor used
+        and the warp is computed directly. */
+    void apply(cv::Mat& frame, FramePool& pool, const cv::Matx23d& M,
+               bool interactive);
+
+    //! hits
+    /*! Frames warped with already-built tables. */
+    uint64_t hits() const { return m_hits; }
+    //! misses
+    /*! Frames that had to (re)build the tables. */
+    uint64_t misses() const { return m_misses; }
+    //! bypasses
+    /*! Frames warped directly because the parameters were in motion. */
+    uint64_t bypasses() const { return m_bypasses; }
+    //! hitRate
+    /*! hits / (hits + misses), 0 before the first cached warp. */
+    double hitRate() const;
+    //! invalidate
+    /*! Forget the current tables (they are rebuilt on the next apply). */
+    void invalidate() { m_valid = false; }
+
+private:
+    void build(const cv::Matx23d& M, cv::Size size);
+
+    cv::Mat m_xy;       // CV_16SC2 integer source coordinates
+    cv::Mat m_weights;  // CV_16UC1 interpolation table indices
+    cv::Matx23d m_matrix;
+    cv::Size m_size;
+    bool m_valid;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_bypasses;
+};
+
+#endif
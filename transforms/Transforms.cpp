@@ -1,16 +1,35 @@
 #include "transforms/Transforms.hpp"
 
+#include <cmath>
+
 namespace Transforms {
 
-void applyTranslateCPU(cv::Mat& frame, double dx, double dy) {
-    if (frame.empty()) return;
-    cv::Mat M = (cv::Mat_<double>(2, 3) << 1.0, 0.0, dx, 0.0, 1.0, dy);
-    cv::warpAffine(frame, frame, M, frame.size(), cv::INTER_LINEAR,
+// Pooled warp target that never aliases `frame`. Transforms are chained,
+// so alternate between two buffers to keep warpAffine out of place (an
+// in-place warp makes OpenCV clone the source internally).
+static cv::Mat& warpTarget(const cv::Mat& frame, FramePool& pool) {
+    cv::Mat& a = pool.acquire("transform.a", frame.size(), frame.type());
+    if (a.data != frame.data) return a;
+    return pool.acquire("transform.b", frame.size(), frame.type());
+}
+
+// Matrices are passed as cv::Matx so building them does not allocate.
+static void warpInto(cv::Mat& frame, FramePool& pool, const cv::Matx23d& M) {
+    cv::Mat& out = warpTarget(frame, pool);
+    cv::warpAffine(frame, out, M, frame.size(), cv::INTER_LINEAR,
                    cv::BORDER_CONSTANT, cv::Scalar(51, 25.5, 25.5));
+    frame = out;
 }
 
-void applyScaleCPU(cv::Mat& frame, double sx, double sy, double pivotX,
-                   double pivotY) {
+void applyTranslateCPU(cv::Mat& frame, FramePool& pool, double dx,
+                       double dy) {
+    if (frame.empty()) return;
+    cv::Matx23d M(1.0, 0.0, dx, 0.0, 1.0, dy);
+    warpInto(frame, pool, M);
+}
+
+void applyScaleCPU(cv::Mat& frame, FramePool& pool, double sx, double sy,
+                   double pivotX, double pivotY) {
     if (frame.empty()) return;
     // If pivot not provided (negative), use image center
     double px = pivotX;
@@ -20,22 +39,68 @@ void applyScaleCPU(cv::Mat& frame, double sx, double sy, double pivotX,
         py = frame.rows * 0.5;
     }
 
-    std::cout << "Scaling about pivot (" << px << ", " << py << ")\n";
     // Build affine: scale about pivot -> T(p) * S * T(-p)
     // Which yields matrix: [ sx 0  (1-sx)*px ; 0 sy (1-sy)*py ]
     double tx = (1.0 - sx) * px;
     double ty = (1.0 - sy) * py;
-    cv::Mat M = (cv::Mat_<double>(2, 3) << sx, 0.0, tx, 0.0, sy, ty);
-    cv::warpAffine(frame, frame, M, frame.size(), cv::INTER_LINEAR,
-                   cv::BORDER_CONSTANT, cv::Scalar(51, 25.5, 25.5));
+    cv::Matx23d M(sx, 0.0, tx, 0.0, sy, ty);
+    warpInto(frame, pool, M);
 }
 
-void applyRotateCPU(cv::Mat& frame, double angleDegrees) {
+void applyRotateCPU(cv::Mat& frame, FramePool& pool, double angleDegrees) {
     if (frame.empty()) return;
-    cv::Point2f center(frame.cols * 0.5f, frame.rows * 0.5f);
-    cv::Mat M = cv::getRotationMatrix2D(center, angleDegrees, 1.0);
-    cv::warpAffine(frame, frame, M, frame.size(), cv::INTER_LINEAR,
+    // Same matrix as cv::getRotationMatrix2D(center, angle, 1.0)
+    double cx = frame.cols * 0.5, cy = frame.rows * 0.5;
+    double a = angleDegrees * CV_PI / 180.0;
+    double ca = std::cos(a), sa = std::sin(a);
+    cv::Matx23d M(ca, sa, (1.0 - ca) * cx - sa * cy, -sa, ca,
+                  sa * cx + (1.0 - ca) * cy);
+    warpInto(frame, pool, M);
+}
+
+bool isIdentityAffine(const cv::Matx23d& M) {
+    const double eps = 1e-9;
+    return std::fabs(M(0, 0) - 1.0) < eps && std::fabs(M(0, 1)) < eps &&
+           std::fabs(M(0, 2)) < eps && std::fabs(M(1, 0)) < eps &&
+           std::fabs(M(1, 1) - 1.0) < eps && std::fabs(M(1, 2)) < eps;
+}
+
+void applyAffineCPU(cv::Mat& frame, FramePool& pool, const cv::Matx23d& M) {
+    // Identity: nothing to resample.
+    if (frame.empty() || isIdentityAffine(M)) return;
+    cv::Mat& out = warpTarget(frame, pool);
+    cv::warpAffine(frame, out, M, frame.size(),
+                   cv::INTER_LINEAR | cv::WARP_INVERSE_MAP,
                    cv::BORDER_CONSTANT, cv::Scalar(51, 25.5, 25.5));
+    frame = out;
+}
+
+cv::Matx33d composeUVTransform(double translateU, double translateV,
+                               double scale, double rotationDegrees,
+                               double aspect) {
+    const double cx = 0.5, cy = 0.5;
+    double a = rotationDegrees * CV_PI / 180.0;
+    double ca = std::cos(a), sa = std::sin(a);
+    if (aspect <= 0.0) aspect = 1.0;
+
+    cv::Matx33d T_neg(1, 0, -cx, 0, 1, -cy, 0, 0, 1);
+    cv::Matx33d A(aspect, 0, 0, 0, 1, 0, 0, 0, 1);
+    cv::Matx33d S(scale, 0, 0, 0, scale, 0, 0, 0, 1);
+    cv::Matx33d R(ca, -sa, 0, sa, ca, 0, 0, 0, 1);
+    cv::Matx33d Ainv(1.0 / aspect, 0, 0, 0, 1, 0, 0, 0, 1);
+    cv::Matx33d T_back(1, 0, cx, 0, 1, cy, 0, 0, 1);
+    cv::Matx33d T_translate(1, 0, translateU, 0, 1, translateV, 0, 0, 1);
+    return T_translate * T_back * Ainv * R * S * A * T_neg;
+}
+
+cv::Matx23d uvToPixelTransform(const cv::Matx33d& uv, cv::Size size) {
+    const double W = size.width, H = size.height;
+    // D: output pixel -> output UV, E: source UV -> source pixel. Pixel Y
+    // runs downward while V runs upward, hence the sign flips.
+    cv::Matx33d D(1.0 / W, 0, 0.5 / W, 0, -1.0 / H, 1.0 - 0.5 / H, 0, 0, 1);
+    cv::Matx33d E(W, 0, -0.5, 0, -H, H - 0.5, 0, 0, 1);
+    cv::Matx33d P = E * uv * D;
+    return cv::Matx23d(P(0, 0), P(0, 1), P(0, 2), P(1, 0), P(1, 1), P(1, 2));
 }
 
 std::string gpuFragmentPathTransform() { return "gpu_transform.frag"; }
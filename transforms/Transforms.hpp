@@ -1,7 +1,7 @@
 /*
  * Transforms.hpp
  *
- * CPU and GPU transform helpers (translate, scale, rotate).
+ * CPU and GPU transform helpers (translate, scale, rotate, composed affine).
  */
 #ifndef TRANSFORMS_HPP
 #define TRANSFORMS_HPP
@@ -9,15 +9,35 @@
 #include <opencv2/opencv.hpp>
 #include <string>
 
+#include "common/FramePool.hpp"
+
 namespace Transforms {
 
-// CPU implementations (operate in-place on cv::Mat frames)
+// CPU implementations (warp into a buffer from `pool` and rebind `frame`
+// to it; the input is never written)
 // pivotX/pivotY (in pixels) specify the point to scale about. If both
 // are negative the function falls back to scaling about the image center.
-void applyTranslateCPU(cv::Mat& frame, double dx, double dy);
-void applyScaleCPU(cv::Mat& frame, double sx, double sy, double pivotX = -1.0,
-                   double pivotY = -1.0);
-void applyRotateCPU(cv::Mat& frame, double angleDegrees);
+void applyTranslateCPU(cv::Mat& frame, FramePool& pool, double dx, double dy);
+void applyScaleCPU(cv::Mat& frame, FramePool& pool, double sx, double sy,
+                   double pivotX = -1.0, double pivotY = -1.0);
+void applyRotateCPU(cv::Mat& frame, FramePool& pool, double angleDegrees);
+
+// Single warp for a composed transform. `M` maps output pixels to source
+// pixels (the same direction as the GPU uTransform), so scale, rotation
+// and translation cost one resampling pass instead of one each.
+void applyAffineCPU(cv::Mat& frame, FramePool& pool, const cv::Matx23d& M);
+bool isIdentityAffine(const cv::Matx23d& M);
+
+// Output-UV -> source-UV transform used by both backends:
+// T_translate * T_back * Ainv * R * S * A * T_neg, i.e. scale and rotate
+// about the center with X stretched by `aspect` so rotations don't shear.
+cv::Matx33d composeUVTransform(double translateU, double translateV,
+                               double scale, double rotationDegrees,
+                               double aspect);
+
+// Express a UV transform (origin bottom-left, V up, texel centers at
+// half-texel offsets) as a pixel-space map for a top-down frame of `size`.
+cv::Matx23d uvToPixelTransform(const cv::Matx33d& uv, cv::Size size);
 
 // GPU helper: return fragment shader path implementing UV-space transform
 std::string gpuFragmentPathTransform();